@@ -1,6 +1,7 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <fstream>
 #include <sstream>
@@ -9,308 +10,4784 @@
 #include <iomanip>
 #include <chrono>
 #include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <queue>
+#include <list>
+#include <deque>
+#include <cstring>
+#include <cstdint>
+#include <charconv>
+#include <functional>
+#include <memory>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#ifdef PPR_WITH_ZLIB
+#include <zlib.h>
+#endif
+#ifdef PPR_WITH_ZSTD
+#include <zstd.h>
+#endif
 
 using namespace std;
 using namespace std::chrono;
 
+// Prints one complete line atomically (jobs and the writer run concurrently)
+void logLine(const string& line) {
+    static mutex log_mutex;
+    lock_guard<mutex> lock(log_mutex);
+    cout << line << endl;
+}
+
+// =========================================================
+// Instrumentation: Scoped Timers, Counters, Trace Events
+// =========================================================
+
+long long peakRSSKilobytes() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Resets the kernel's peak-RSS mark (VmHWM) to the current RSS; false when
+// /proc/self/clear_refs refuses it (Linux < 4.0, restricted /proc). Freed
+// heap is handed back first so it does not count towards the next peak.
+bool resetPeakRSS() {
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+    int fd = open("/proc/self/clear_refs", O_WRONLY);
+    if (fd < 0) return false;
+    bool ok = write(fd, "5", 1) == 1;
+    close(fd);
+    return ok;
+}
+
+// Peak RSS since the last resetPeakRSS() (VmHWM), or -1 when unavailable.
+// getrusage cannot be used for this: it keeps the peak of exited threads.
+long long phasePeakRSSKilobytes() {
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line))
+        if (line.compare(0, 6, "VmHWM:") == 0) return atoll(line.c_str() + 6);
+    return -1;
+}
+
+// Process-wide collector of timed phases and counters. Disabled by
+// default; when enabled it prints a report at exit and can also write the
+// spans as Chrome trace-event JSON (chrome://tracing, Perfetto).
+class Profiler {
+    struct Span {
+        string name;
+        long long start_us, duration_us;
+        size_t thread_id;
+    };
+    struct PhaseStats {
+        long long count = 0, total_us = 0, max_us = 0;
+    };
+
+    mutex m;
+    vector<Span> spans;
+    vector<pair<string, PhaseStats>> phases;     // in first-seen order
+    vector<pair<string, long long>> counters;    // in first-seen order
+    high_resolution_clock::time_point origin = high_resolution_clock::now();
+
+    template <typename T>
+    static T& lookup(vector<pair<string, T>>& table, const string& name) {
+        for (auto& e : table) if (e.first == name) return e.second;
+        table.push_back({name, T()});
+        return table.back().second;
+    }
+
+    Profiler() = default;
+    ~Profiler() {
+        if (!enabled) return;
+        report(cout);
+        if (!trace_file.empty()) writeChromeTrace(trace_file);
+    }
+
+public:
+    bool enabled = false;
+    string trace_file;   // Chrome trace output ("" = none)
+
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    long long nowUs() const {
+        return duration_cast<microseconds>(high_resolution_clock::now() - origin).count();
+    }
+
+    void addCounter(const string& name, long long delta) {
+        if (!enabled) return;
+        lock_guard<mutex> lock(m);
+        lookup(counters, name) += delta;
+    }
+
+    void recordSpan(const string& name, long long start_us, long long duration_us) {
+        if (!enabled) return;
+        lock_guard<mutex> lock(m);
+        spans.push_back({name, start_us, duration_us, hash<thread::id>()(this_thread::get_id())});
+        PhaseStats& s = lookup(phases, name);
+        s.count++;
+        s.total_us += duration_us;
+        s.max_us = max(s.max_us, duration_us);
+    }
+
+    void report(ostream& out) {
+        lock_guard<mutex> lock(m);
+        out << "\n=== Performance Report ===\n";
+        out << left << setw(28) << "Phase" << right << setw(8) << "Count"
+            << setw(14) << "Total(us)" << setw(14) << "Max(us)" << "\n";
+        for (auto& p : phases)
+            out << left << setw(28) << p.first << right << setw(8) << p.second.count
+                << setw(14) << p.second.total_us << setw(14) << p.second.max_us << "\n";
+        out << left << setw(28) << "Counter" << right << setw(22) << "Value" << "\n";
+        for (auto& c : counters)
+            out << left << setw(28) << c.first << right << setw(22) << c.second << "\n";
+        long long io_us = lookup(phases, "io.read").total_us, io_bytes = lookup(counters, "io.bytes_read");
+        if (io_us > 0)
+            out << left << setw(28) << "io.read_mb_per_s" << right << setw(22)
+                << fixed << setprecision(1) << io_bytes / (double)io_us << defaultfloat << "\n";
+        out << left << setw(28) << "peak_rss_kb" << right << setw(22) << peakRSSKilobytes() << "\n";
+        out << left;
+    }
+
+    void writeChromeTrace(const string& filename) {
+        lock_guard<mutex> lock(m);
+        ofstream file(filename);
+        file << "{\"traceEvents\":[";
+        for (size_t i = 0; i < spans.size(); ++i) {
+            const Span& s = spans[i];
+            file << (i ? "," : "") << "\n{\"name\":\"" << s.name << "\",\"ph\":\"X\",\"pid\":1"
+                 << ",\"tid\":" << (s.thread_id % 100000) << ",\"ts\":" << s.start_us
+                 << ",\"dur\":" << s.duration_us << "}";
+        }
+        file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+        cout << "-> Saved Chrome trace to: " << filename << endl;
+    }
+};
+
+// Times the enclosing scope as one span of the named phase
+class ScopedTimer {
+    const char* name;
+    long long start_us;
+    bool active;
+
+public:
+    explicit ScopedTimer(const char* phase)
+        : name(phase), active(Profiler::instance().enabled) {
+        if (active) start_us = Profiler::instance().nowUs();
+    }
+    ~ScopedTimer() {
+        if (!active) return;
+        Profiler& p = Profiler::instance();
+        p.recordSpan(name, start_us, p.nowUs() - start_us);
+    }
+};
+
+// ---------- Hardware Performance Counters ----------
+
+// Counter values over some interval; -1 marks an event that could not be
+// opened (no PMU access in containers, perf_event_paranoid, non-Linux).
+struct HwCounts {
+    long long cycles = -1;
+    long long instructions = -1;
+    long long llc_misses = -1;
+    long long dtlb_misses = -1;
+    long long branch_misses = -1;
+
+    bool available() const {
+        return cycles >= 0 || instructions >= 0 || llc_misses >= 0 ||
+               dtlb_misses >= 0 || branch_misses >= 0;
+    }
+
+    HwCounts operator-(const HwCounts& o) const {
+        auto d = [](long long a, long long b) { return (a < 0 || b < 0) ? -1LL : a - b; };
+        return {d(cycles, o.cycles), d(instructions, o.instructions), d(llc_misses, o.llc_misses),
+                d(dtlb_misses, o.dtlb_misses), d(branch_misses, o.branch_misses)};
+    }
+
+    // Appends ,"cycles":N,... (null for unavailable events) to a JSON object
+    void writeJSONFields(ostream& out) const {
+        auto field = [&](const char* name, long long v) {
+            out << ",\"" << name << "\":";
+            if (v < 0) out << "null"; else out << v;
+        };
+        field("cycles", cycles);
+        field("instructions", instructions);
+        field("llc_misses", llc_misses);
+        field("dtlb_misses", dtlb_misses);
+        field("branch_misses", branch_misses);
+        out << ",\"ipc\":";
+        if (cycles > 0 && instructions >= 0) out << (double)instructions / cycles; else out << "null";
+    }
+};
+
+// User-space counters for the calling thread (and threads it spawns while
+// open), read with multiplexing correction. Each event is opened on its
+// own so a PMU lacking one event still reports the rest. Off unless
+// enabled(); when the kernel refuses every event a single warning is
+// printed and all reads return -1.
+class HwCounterGroup {
+    static const int NUM_EVENTS = 5;
+    int fds[NUM_EVENTS];
+
+#ifdef __linux__
+    static int openEvent(uint32_t type, uint64_t config) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.inherit = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    static long long readEvent(int fd) {
+        if (fd < 0) return -1;
+        uint64_t v[3];   // value, time_enabled, time_running
+        if (::read(fd, v, sizeof(v)) != (ssize_t)sizeof(v)) return -1;
+        if (v[2] == 0) return 0;
+        return (long long)((double)v[0] * v[1] / v[2]);
+    }
+#endif
+
+public:
+    static bool& enabled() {
+        static bool on = false;
+        return on;
+    }
+
+    HwCounterGroup() {
+        for (int& fd : fds) fd = -1;
+        if (!enabled()) return;
+#ifdef __linux__
+        fds[0] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds[1] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds[2] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds[3] = openEvent(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+                           (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        fds[4] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+        bool any = false;
+        for (int fd : fds) any |= fd >= 0;
+        static once_flag warned;
+        if (!any)
+            call_once(warned, [] {
+                logLine("[HW] Performance counters unavailable (" + string(strerror(errno)) +
+                        "); continuing without them");
+            });
+    }
+    ~HwCounterGroup() {
+        for (int fd : fds) if (fd >= 0) close(fd);
+    }
+    HwCounterGroup(const HwCounterGroup&) = delete;
+    HwCounterGroup& operator=(const HwCounterGroup&) = delete;
+
+    bool active() const {
+        for (int fd : fds) if (fd >= 0) return true;
+        return false;
+    }
+
+    // Running totals since the group was opened
+    HwCounts read() const {
+        HwCounts c;
+#ifdef __linux__
+        if (!active()) return c;
+        c.cycles = readEvent(fds[0]);
+        c.instructions = readEvent(fds[1]);
+        c.llc_misses = readEvent(fds[2]);
+        c.dtlb_misses = readEvent(fds[3]);
+        c.branch_misses = readEvent(fds[4]);
+#endif
+        return c;
+    }
+
+    // Totals also go to the profiler report as hw.<phase>.<event>
+    static void report(const string& phase, const HwCounts& c) {
+        Profiler& p = Profiler::instance();
+        if (!p.enabled || !c.available()) return;
+        if (c.cycles >= 0) p.addCounter("hw." + phase + ".cycles", c.cycles);
+        if (c.instructions >= 0) p.addCounter("hw." + phase + ".instructions", c.instructions);
+        if (c.llc_misses >= 0) p.addCounter("hw." + phase + ".llc_misses", c.llc_misses);
+        if (c.dtlb_misses >= 0) p.addCounter("hw." + phase + ".dtlb_misses", c.dtlb_misses);
+        if (c.branch_misses >= 0) p.addCounter("hw." + phase + ".branch_misses", c.branch_misses);
+    }
+};
+
+// =========================================================
+// SECTION 1: Core Data Structures
+// =========================================================
+
+static uint64_t hashNodeName(string_view s) {
+    uint64_t h = 0xcbf29ce484222325ULL;   // FNV-1a, then a final mix
+    for (unsigned char c : s) h = (h ^ c) * 0x100000001b3ULL;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    return h ^ (h >> 33);
+}
+
+// Persistent node dictionary: a minimal perfect hash (CHD-style
+// hash-and-displace) over the names plus the packed name table, used
+// straight from mmap so name <-> id lookups need no startup hashing.
+// Keys fall into ~n/4 buckets; each multi-key bucket stores the
+// displacement that sends all its keys to free slots, singleton buckets
+// store their slot directly (high bit set). A lookup hashes once, reads
+// one displacement and verifies the name, so unknown names return -1.
+//
+// On-disk layout (little-endian, every section 8-byte aligned):
+//   char     magic[8]          "PPRDIC1"
+//   uint64   num_nodes, num_buckets, name_bytes
+//   uint32   displacement[num_buckets]
+//   uint32   slot_to_id[num_nodes]
+//   uint64   offsets[num_nodes + 1]  name range per id
+//   char     names[name_bytes]
+class NodeDictionary {
+    struct Header {
+        char magic[8];
+        uint64_t num_nodes;
+        uint64_t num_buckets;
+        uint64_t name_bytes;
+    };
+
+    void* mapping = MAP_FAILED;
+    size_t mapping_size = 0;
+    const Header* header = nullptr;
+    const uint32_t* displacement = nullptr;
+    const uint32_t* slot_to_id = nullptr;
+    const uint64_t* offsets = nullptr;
+    const char* names = nullptr;
+
+    static const uint32_t DIRECT = 0x80000000u;
+
+    static uint64_t slotHash(uint64_t h, uint32_t d) {
+        uint64_t x = h + (d + 1) * 0x9e3779b97f4a7c15ULL;   // splitmix64 finalizer
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+public:
+    NodeDictionary() = default;
+    NodeDictionary(const NodeDictionary&) = delete;
+    NodeDictionary& operator=(const NodeDictionary&) = delete;
+    ~NodeDictionary() { unload(); }
+
+    void unload() {
+        if (mapping != MAP_FAILED) munmap(mapping, mapping_size);
+        mapping = MAP_FAILED;
+        header = nullptr;
+    }
+
+    // Builds the dictionary for ids 0..n-1; appendName(out, id) must append
+    // the (distinct) name of each id.
+    template <typename NameFn>
+    static bool build(int n, NameFn appendName, const string& filename) {
+        string arena;
+        vector<uint64_t> offs = {0};
+        for (int id = 0; id < n; ++id) {
+            appendName(arena, id);
+            offs.push_back(arena.size());
+        }
+        auto name = [&](int id) { return string_view(arena.data() + offs[id], offs[id + 1] - offs[id]); };
+
+        uint64_t nb = n / 4 + 1;
+        vector<uint64_t> hashes(n);
+        vector<uint32_t> bucket_start(nb + 1, 0), members(n);
+        for (int id = 0; id < n; ++id) {
+            hashes[id] = hashNodeName(name(id));
+            bucket_start[(hashes[id] >> 32) % nb + 1]++;
+        }
+        for (uint64_t b = 0; b < nb; ++b) bucket_start[b + 1] += bucket_start[b];
+
+        // Equal hashes (duplicate names) can never be placed: fail up front
+        // rather than exhausting every displacement
+        {
+            vector<uint64_t> sorted_hashes(hashes);
+            sort(sorted_hashes.begin(), sorted_hashes.end());
+            if (adjacent_find(sorted_hashes.begin(), sorted_hashes.end()) != sorted_hashes.end()) return false;
+        }
+        vector<uint32_t> cursor(bucket_start.begin(), bucket_start.end() - 1);
+        for (int id = 0; id < n; ++id) members[cursor[(hashes[id] >> 32) % nb]++] = id;
+
+        // Largest buckets first, while most slots are still free
+        vector<uint32_t> order(nb);
+        for (uint64_t b = 0; b < nb; ++b) order[b] = b;
+        auto size = [&](uint32_t b) { return bucket_start[b + 1] - bucket_start[b]; };
+        stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return size(a) > size(b); });
+
+        vector<uint32_t> disp(nb, 0), slot_id(n, UINT32_MAX);
+        vector<uint64_t> slots;
+        size_t next_free = 0;
+        for (uint32_t b : order) {
+            uint32_t s = size(b);
+            if (s == 0) break;
+            const uint32_t* keys = &members[bucket_start[b]];
+            if (s == 1) {
+                while (slot_id[next_free] != UINT32_MAX) next_free++;
+                slot_id[next_free] = keys[0];
+                disp[b] = DIRECT | (uint32_t)next_free;
+                continue;
+            }
+            for (uint32_t d = 0;; ++d) {
+                if (d == DIRECT) return false;
+                slots.clear();
+                bool ok = true;
+                for (uint32_t k = 0; k < s && ok; ++k) {
+                    uint64_t slot = slotHash(hashes[keys[k]], d) % n;
+                    ok = slot_id[slot] == UINT32_MAX &&
+                         find(slots.begin(), slots.end(), slot) == slots.end();
+                    slots.push_back(slot);
+                }
+                if (!ok) continue;
+                for (uint32_t k = 0; k < s; ++k) slot_id[slots[k]] = keys[k];
+                disp[b] = d;
+                break;
+            }
+        }
+
+        ofstream file(filename, ios::binary);
+        if (!file.is_open()) return false;
+        Header hdr = {{'P', 'P', 'R', 'D', 'I', 'C', '1', 0},
+                      (uint64_t)n, nb, (uint64_t)arena.size()};
+        auto writeAligned = [&](const void* data, size_t bytes) {
+            file.write((const char*)data, bytes);
+            static const char pad[8] = {0};
+            if (bytes % 8) file.write(pad, 8 - bytes % 8);
+        };
+        writeAligned(&hdr, sizeof(hdr));
+        writeAligned(disp.data(), disp.size() * sizeof(uint32_t));
+        writeAligned(slot_id.data(), slot_id.size() * sizeof(uint32_t));
+        writeAligned(offs.data(), offs.size() * sizeof(uint64_t));
+        writeAligned(arena.data(), arena.size());
+        return file.good();
+    }
+
+    // Maps a dictionary file; fails if it is missing or malformed
+    bool load(const string& filename) {
+        unload();
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Header)) { close(fd); return false; }
+        mapping_size = st.st_size;
+        mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) return false;
+
+        auto align8 = [](size_t b) { return (b + 7) & ~(size_t)7; };
+        const char* base = (const char*)mapping;
+        header = (const Header*)base;
+        // Section sizes are bounded by the file before they are summed
+        if (memcmp(header->magic, "PPRDIC1", 8) != 0 || header->num_nodes >= (uint64_t)INT32_MAX ||
+            header->num_buckets > mapping_size || header->name_bytes > mapping_size ||
+            (header->num_nodes > 0 && header->num_buckets == 0)) {
+            unload();
+            return false;
+        }
+        size_t N = header->num_nodes, B = header->num_buckets;
+        size_t pos = align8(sizeof(Header));
+        displacement = (const uint32_t*)(base + pos); pos += align8(B * sizeof(uint32_t));
+        slot_to_id = (const uint32_t*)(base + pos);   pos += align8(N * sizeof(uint32_t));
+        offsets = (const uint64_t*)(base + pos);      pos += align8((N + 1) * sizeof(uint64_t));
+        names = base + pos;                           pos += align8(header->name_bytes);
+        if (pos > mapping_size || offsets[0] != 0 || offsets[N] != header->name_bytes) {
+            unload();
+            return false;
+        }
+        // findId and nameView index with these directly, so check them all
+        for (size_t i = 0; i < N; ++i)
+            if (offsets[i] > offsets[i + 1] || slot_to_id[i] >= N) {
+                unload();
+                return false;
+            }
+        for (size_t b = 0; b < B; ++b)
+            if ((displacement[b] & DIRECT) && (displacement[b] & ~DIRECT) >= N) {
+                unload();
+                return false;
+            }
+        return true;
+    }
+
+    bool loaded() const { return header != nullptr; }
+    int size() const { return header ? header->num_nodes : 0; }
+
+    string_view nameView(int id) const {
+        return string_view(names + offsets[id], offsets[id + 1] - offsets[id]);
+    }
+
+    // Id of 'name', or -1 when it is not in the dictionary
+    int findId(string_view name) const {
+        if (!header || header->num_nodes == 0) return -1;
+        uint64_t h = hashNodeName(name);
+        uint32_t d = displacement[(h >> 32) % header->num_buckets];
+        uint64_t slot = (d & DIRECT) ? (d & ~DIRECT) : slotHash(h, d) % header->num_nodes;
+        int id = slot_to_id[slot];
+        return (id >= 0 && nameView(id) == name) ? id : -1;
+    }
+};
+
+// Maps string-based node identifiers to compact integer IDs
+// Names are interned once in a contiguous arena; an open-addressing table
+// of 32-bit ids indexes into it, so a node costs its name length plus
+// about 12 bytes (8-byte offset, ~4-5 bytes of table at <= 75% load).
+// Graphs whose ids are all plain integers skip the arena entirely: names
+// are kept as int64 values (plus a value-sorted index for lookups) and
+// formatted on demand. A mapper can also be backed by a mapped
+// NodeDictionary, which then fixes the id of every known name.
+class NodeMapper {
+    string arena;                  // All names back to back
+    vector<uint64_t> offsets{0};   // Name i spans arena[offsets[i], offsets[i+1])
+    vector<uint32_t> table;        // id + 1 per slot, 0 = empty
+    size_t mask = 0;
+
+    bool numeric = false;          // Names held in numeric_names instead
+    vector<int64_t> numeric_names; // Integer name of each id
+    vector<uint32_t> numeric_index;// Ids sorted by numeric name
+
+    NodeDictionary dict;           // Mapped dictionary (when loaded)
+
+    string_view arenaView(int id) const {
+        return string_view(arena.data() + offsets[id], offsets[id + 1] - offsets[id]);
+    }
+
+    // Slot holding 'name', or the empty slot where it would be inserted
+    size_t probe(string_view name) const {
+        size_t i = hashNodeName(name) & mask;
+        while (table[i] != 0 && arenaView(table[i] - 1) != name) i = (i + 1) & mask;
+        return i;
+    }
+
+    void grow() {
+        size_t cap = table.empty() ? 1024 : table.size() * 2;
+        vector<uint32_t>(cap, 0).swap(table);
+        mask = cap - 1;
+        for (int id = 0; id + 1 < (int)offsets.size(); ++id) {
+            size_t i = hashNodeName(arenaView(id)) & mask;
+            while (table[i] != 0) i = (i + 1) & mask;
+            table[i] = id + 1;
+        }
+    }
+
+    int insertArena(string_view name) {
+        if ((offsets.size() + 1) * 4 > table.size() * 3) grow();
+        size_t slot = probe(name);
+        if (table[slot] != 0) return table[slot] - 1;
+        int new_id = offsets.size() - 1;
+        arena.append(name);
+        offsets.push_back(arena.size());
+        table[slot] = new_id + 1;
+        return new_id;
+    }
+
+    // Copies numeric or dictionary names into the string arena, keeping
+    // ids, so a name outside them can be added
+    void materialize() {
+        string name;
+        for (int id = 0; id < getNumNodes(); ++id) {
+            name.clear();
+            appendName(name, id);
+            insertArena(name);
+        }
+        numeric = false;
+        vector<int64_t>().swap(numeric_names);
+        vector<uint32_t>().swap(numeric_index);
+        dict.unload();
+    }
+
+public:
+    // Parses a canonical non-negative decimal id ("0", "42"; not "007", "+1")
+    static bool parseNumericName(string_view s, int64_t& value) {
+        if (s.empty() || s.size() > 18 || (s.size() > 1 && s[0] == '0')) return false;
+        int64_t v = 0;
+        for (char c : s) {
+            if (c < '0' || c > '9') return false;
+            v = v * 10 + (c - '0');
+        }
+        value = v;
+        return true;
+    }
+
+    // Installs integer names for ids 0..names.size()-1 (mapper must be empty)
+    void assignNumericNames(vector<int64_t>&& names) {
+        numeric = true;
+        numeric_names = move(names);
+        numeric_names.shrink_to_fit();
+        numeric_index.resize(numeric_names.size());
+        for (size_t i = 0; i < numeric_index.size(); ++i) numeric_index[i] = i;
+        sort(numeric_index.begin(), numeric_index.end(),
+             [&](uint32_t a, uint32_t b) { return numeric_names[a] < numeric_names[b]; });
+    }
+
+    // Forgets every name, including a mapped dictionary
+    void clear() {
+        string().swap(arena);
+        offsets.assign(1, 0);
+        vector<uint32_t>().swap(table);
+        mask = 0;
+        numeric = false;
+        vector<int64_t>().swap(numeric_names);
+        vector<uint32_t>().swap(numeric_index);
+        dict.unload();
+    }
+
+    // Installs arena names for ids 0..n-1 (distinct; mapper must be empty).
+    // The hash table is filled by 'threads' threads claiming slots with CAS.
+    void assignArenaNames(string&& names, vector<uint64_t>&& ends, int threads) {
+        arena = move(names);
+        offsets = move(ends);
+        int n = offsets.size() - 1;
+        size_t cap = 1024;
+        while ((size_t)(n + 2) * 4 > cap * 3) cap *= 2;
+        vector<uint32_t>(cap, 0).swap(table);
+        mask = cap - 1;
+        threads = max(1, min(threads, n));
+        vector<thread> workers;
+        for (int t = 0; t < threads; ++t)
+            workers.emplace_back([&, t] {
+                for (int id = (long long)n * t / threads; id < (long long)n * (t + 1) / threads; ++id) {
+                    size_t i = hashNodeName(arenaView(id)) & mask;
+                    uint32_t empty = 0;
+                    while (!__atomic_compare_exchange_n(&table[i], &empty, (uint32_t)id + 1, false,
+                                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                        i = (i + 1) & mask;
+                        empty = 0;
+                    }
+                }
+            });
+        for (auto& w : workers) w.join();
+    }
+
+    // Maps a dictionary written by saveDictionary (mapper must be empty)
+    bool loadDictionary(const string& filename) {
+        return getNumNodes() == 0 && dict.load(filename);
+    }
+    bool hasDictionary() const { return dict.loaded(); }
+
+    bool saveDictionary(const string& filename) const {
+        return NodeDictionary::build(getNumNodes(),
+                                     [&](string& out, int id) { appendName(out, id); }, filename);
+    }
+
+    // Returns the ID of a node, creating it if it does not exist
+    int getId(string_view name) {
+        if (numeric || dict.loaded()) {
+            int id = findId(name);
+            if (id >= 0) return id;
+            materialize();
+        }
+        return insertArena(name);
+    }
+
+    // Appends the name of a valid id to 'out' without a temporary string
+    void appendName(string& out, int id) const {
+        if (dict.loaded()) {
+            out += dict.nameView(id);
+            return;
+        }
+        if (!numeric) {
+            out += arenaView(id);
+            return;
+        }
+        char num[24];
+        auto res = to_chars(num, num + sizeof(num), numeric_names[id]);
+        out.append(num, res.ptr - num);
+    }
+
+    // Converts numeric ID back to original node name
+    string getName(int id) const {
+        if (id < 0 || id >= getNumNodes()) return "UNKNOWN";
+        string name;
+        appendName(name, id);
+        return name;
+    }
+
+    // Looks up a node without creating it; returns -1 when unknown
+    int findId(string_view name) const {
+        if (dict.loaded()) return dict.findId(name);
+        if (numeric) {
+            int64_t value;
+            if (!parseNumericName(name, value)) return -1;
+            auto it = lower_bound(numeric_index.begin(), numeric_index.end(), value,
+                                  [&](uint32_t id, int64_t v) { return numeric_names[id] < v; });
+            return (it != numeric_index.end() && numeric_names[*it] == value) ? (int)*it : -1;
+        }
+        if (table.empty()) return -1;
+        size_t slot = probe(name);
+        return (int)table[slot] - 1;
+    }
+
+    int getNumNodes() const {
+        if (dict.loaded()) return dict.size();
+        return numeric ? numeric_names.size() : offsets.size() - 1;
+    }
+
+    // Heap footprint of the arena, offsets and hash table (or numeric names;
+    // a mapped dictionary lives in the page cache and is not counted)
+    size_t memoryBytes() const {
+        return arena.capacity() + offsets.capacity() * sizeof(uint64_t)
+             + table.capacity() * sizeof(uint32_t)
+             + numeric_names.capacity() * sizeof(int64_t)
+             + numeric_index.capacity() * sizeof(uint32_t);
+    }
+
+    // Utility function: selects a random node name (used for auto seed selection)
+    string getRandomNodeName() {
+        if (getNumNodes() == 0) return "";
+        return getName(rand() % getNumNodes());
+    }
+};
+
+// Compressed Sparse Row (CSR) representation for directed weighted graphs
+struct CSRGraph {
+    int num_nodes;
+    int num_edges;
+
+    vector<int> row_ptr;          // Start index of outgoing edges per node
+    vector<int> col_indices;      // Destination node IDs
+    vector<double> edge_weights;  // Edge weights
+    vector<double> out_weight_sum;// Sum of outgoing weights per node
+
+    // Temporal graphs only (empty otherwise): per-edge timestamps and the
+    // undecayed weights that edge_weights is re-derived from per query time
+    vector<int64_t> edge_times;
+    vector<double> base_weights;
+
+    CSRGraph(int n) : num_nodes(n), num_edges(0) {
+        row_ptr.resize(n + 1, 0);
+        out_weight_sum.resize(n, 0.0);
+    }
+};
+
+// =========================================================
+// Graph Loader (Supports Weighted & Unweighted Datasets)
+// =========================================================
+
+// ---------- Asynchronous Block Reader (io_uring / pread threads) ----------
+
+// Reads exactly 'bytes' at 'offset', retrying short reads
+static bool preadFull(int fd, void* dst, size_t bytes, uint64_t offset) {
+    char* p = (char*)dst;
+    while (bytes > 0) {
+        ssize_t n = pread(fd, p, bytes, offset);
+        if (n <= 0) return false;
+        p += n;
+        bytes -= n;
+        offset += n;
+    }
+    return true;
+}
+
+// Reads a file front to back in large blocks with up to 'depth' reads in
+// flight. The ring of block buffers is the bounded queue between the
+// reads and the parser: next() hands out blocks in file order, and the
+// previous block's buffer is reused for a new read on the following
+// call. io_uring is driven through raw syscalls (no liburing). When the
+// kernel or a seccomp filter refuses it, one pread thread per buffer
+// is used instead.
+class AsyncBlockReader {
+    struct Slot {
+        vector<char> data;
+        uint64_t block = 0;
+        size_t size = 0;
+        bool ready = false;
+    };
+
+    int fd = -1;
+    uint64_t file_size = 0;
+    size_t block_bytes = 0;
+    uint64_t num_blocks = 0;
+    uint64_t cursor = 0;        // next block handed to the consumer
+    uint64_t submitted = 0;     // blocks whose read has been issued
+    uint64_t reaped = 0;        // completions taken off the ring
+    uint64_t delivered = 0;     // bytes handed to the consumer
+    vector<Slot> slots;
+    bool error = false;         // written by the pread workers under 'm'
+    long long start_us = 0, end_us = -1;
+
+    // io_uring state
+    int ring_fd = -1;
+    void* sq_ring = MAP_FAILED;
+    void* cq_ring = MAP_FAILED;
+    size_t sq_ring_size = 0, cq_ring_size = 0;
+    struct io_uring_sqe* sqes = (struct io_uring_sqe*)MAP_FAILED;
+    size_t sqes_size = 0;
+    unsigned *sq_head = nullptr, *sq_tail = nullptr, *sq_mask = nullptr, *sq_array = nullptr;
+    unsigned *cq_head = nullptr, *cq_tail = nullptr, *cq_mask = nullptr;
+    struct io_uring_cqe* cqes = nullptr;
+
+    // pread fallback state
+    vector<thread> workers;
+    mutable mutex m;
+    condition_variable cv;
+    bool stopping = false;
+
+    size_t blockSize(uint64_t block) const {
+        return min<uint64_t>(block_bytes, file_size - block * block_bytes);
+    }
+
+    bool setupRing(unsigned entries) {
+        struct io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        ring_fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+        if (ring_fd < 0) return false;
+
+        sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) sq_ring_size = cq_ring_size = max(sq_ring_size, cq_ring_size);
+        sq_ring = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ring_fd, IORING_OFF_SQ_RING);
+        if (sq_ring == MAP_FAILED) return false;
+        cq_ring = single ? sq_ring
+                         : mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                ring_fd, IORING_OFF_CQ_RING);
+        if (cq_ring == MAP_FAILED) return false;
+        sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+        sqes = (struct io_uring_sqe*)mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE,
+                                          MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return false;
+
+        char* sq = (char*)sq_ring;
+        char* cq = (char*)cq_ring;
+        sq_head = (unsigned*)(sq + params.sq_off.head);
+        sq_tail = (unsigned*)(sq + params.sq_off.tail);
+        sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+        sq_array = (unsigned*)(sq + params.sq_off.array);
+        cq_head = (unsigned*)(cq + params.cq_off.head);
+        cq_tail = (unsigned*)(cq + params.cq_off.tail);
+        cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+        cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    // Waits for every issued read to complete, so the kernel no longer
+    // writes into the slots once the ring is unmapped and they are freed
+    void drainRing() {
+        while (reaped < submitted) {
+            unsigned head = *cq_head;
+            if (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+                __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+                reaped++;
+                continue;
+            }
+            // Also submit SQEs left behind by a failed io_uring_enter
+            unsigned pending = *sq_tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+            if (syscall(__NR_io_uring_enter, ring_fd, pending, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+                errno != EINTR)
+                return;
+        }
+    }
+
+    void teardownRing() {
+        if (sqes != MAP_FAILED) munmap(sqes, sqes_size);
+        if (cq_ring != MAP_FAILED && cq_ring != sq_ring) munmap(cq_ring, cq_ring_size);
+        if (sq_ring != MAP_FAILED) munmap(sq_ring, sq_ring_size);
+        if (ring_fd >= 0) ::close(ring_fd);
+        sqes = (struct io_uring_sqe*)MAP_FAILED;
+        sq_ring = cq_ring = MAP_FAILED;
+        ring_fd = -1;
+    }
+
+    // Queues the read of the next block into its slot (io_uring backend)
+    bool submitNext() {
+        if (submitted >= num_blocks) return true;
+        uint64_t block = submitted++;
+        Slot& slot = slots[block % slots.size()];
+        slot.block = block;
+        slot.size = blockSize(block);
+        slot.ready = false;
+
+        unsigned tail = *sq_tail;
+        unsigned index = tail & *sq_mask;
+        struct io_uring_sqe* sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = fd;
+        sqe->addr = (uint64_t)slot.data.data();
+        sqe->len = slot.size;
+        sqe->off = block * block_bytes;
+        sqe->user_data = block;
+        sq_array[index] = index;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+        return syscall(__NR_io_uring_enter, ring_fd, 1, 0, 0, nullptr, 0) >= 0;
+    }
+
+    // Reaps completions until block 'want' has landed (io_uring backend)
+    bool waitFor(uint64_t want) {
+        Slot& target = slots[want % slots.size()];
+        while (!target.ready) {
+            unsigned head = *cq_head;
+            if (head == __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+                if (syscall(__NR_io_uring_enter, ring_fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 &&
+                    errno != EINTR)
+                    return false;
+                continue;
+            }
+            struct io_uring_cqe* cqe = &cqes[head & *cq_mask];
+            uint64_t block = cqe->user_data;
+            int res = cqe->res;
+            __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+            reaped++;
+
+            // Short or refused reads are finished synchronously
+            Slot& slot = slots[block % slots.size()];
+            size_t got = res > 0 ? res : 0;
+            if (got < slot.size &&
+                !preadFull(fd, slot.data.data() + got, slot.size - got, block * block_bytes + got))
+                return false;
+            slot.ready = true;
+        }
+        return true;
+    }
+
+    void startThreads() {
+        int depth = slots.size();
+        for (int t = 0; t < depth; ++t) {
+            workers.emplace_back([this, t, depth] {
+                for (uint64_t block = t; block < num_blocks; block += depth) {
+                    Slot& slot = slots[t];
+                    {
+                        // Wait until the consumer has released this slot's previous block
+                        unique_lock<mutex> lock(m);
+                        cv.wait(lock, [&] { return stopping || !slot.ready; });
+                        if (stopping) return;
+                    }
+                    size_t size = blockSize(block);
+                    bool ok = preadFull(fd, slot.data.data(), size, block * block_bytes);
+                    {
+                        lock_guard<mutex> lock(m);
+                        slot.block = block;
+                        slot.size = size;
+                        slot.ready = true;
+                        error = error || !ok;
+                    }
+                    cv.notify_all();
+                    if (!ok) return;
+                }
+            });
+        }
+    }
+
+public:
+    AsyncBlockReader() = default;
+    AsyncBlockReader(const AsyncBlockReader&) = delete;
+    AsyncBlockReader& operator=(const AsyncBlockReader&) = delete;
+    ~AsyncBlockReader() { close(); }
+
+    bool open(const string& filename, size_t block_size = 4 << 20, int depth = 4) {
+        fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) return false;
+        file_size = st.st_size;
+        block_bytes = block_size;
+        num_blocks = (file_size + block_bytes - 1) / block_bytes;
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        slots.resize(max(1, depth));
+        for (Slot& s : slots) s.data.resize(block_bytes);
+        start_us = Profiler::instance().nowUs();
+
+        if (setupRing(slots.size())) {
+            for (size_t i = 0; i < slots.size(); ++i)
+                if (!submitNext()) { error = true; break; }
+        } else {
+            teardownRing();
+            startThreads();
+        }
+        return true;
+    }
+
+    const char* backend() const { return ring_fd >= 0 ? "io_uring" : "pread"; }
+    uint64_t size() const { return file_size; }
+    bool failed() const {
+        lock_guard<mutex> lock(m);
+        return error;
+    }
+
+    // Next block in file order, valid until the following call; false at
+    // the end of the file or on a read error
+    bool next(const char*& data, size_t& size) {
+        if (cursor >= num_blocks || failed()) return false;
+        Slot& slot = slots[cursor % slots.size()];
+        if (ring_fd >= 0) {
+            // The previous block's slot is free again: keep the queue full
+            if (cursor > 0 && !submitNext()) error = true;
+            if (error || !waitFor(cursor)) {
+                error = true;
+                return false;
+            }
+        } else {
+            unique_lock<mutex> lock(m);
+            if (cursor > 0) {
+                slots[(cursor - 1) % slots.size()].ready = false;
+                cv.notify_all();
+            }
+            cv.wait(lock, [&] { return error || (slot.ready && slot.block == cursor); });
+            if (error) return false;
+        }
+        data = slot.data.data();
+        size = slot.size;
+        delivered += size;
+        if (++cursor == num_blocks) end_us = Profiler::instance().nowUs();
+        return true;
+    }
+
+    void close() {
+        if (fd < 0) return;
+        if (!workers.empty()) {
+            {
+                lock_guard<mutex> lock(m);
+                stopping = true;
+            }
+            cv.notify_all();
+            for (auto& w : workers) w.join();
+            workers.clear();
+        }
+        if (ring_fd >= 0) drainRing();
+        teardownRing();
+        ::close(fd);
+        fd = -1;
+
+        // Span and byte count give the achieved read bandwidth in the report
+        Profiler& prof = Profiler::instance();
+        if (end_us < 0) end_us = prof.nowUs();
+        prof.recordSpan("io.read", start_us, end_us - start_us);
+        prof.addCounter("io.bytes_read", delivered);
+    }
+};
+
+// ---------- Compressed Input (.gz / .zst) ----------
+
+// Sequential byte source for the loaders. Plain files stream through
+// AsyncBlockReader. .gz and .zst files are decoded on a background thread
+// into a bounded queue of blocks that the parser drains, so no
+// decompressed copy ever touches the disk. Decoding uses zlib
+// (-DPPR_WITH_ZLIB, link -lz) and libzstd (-DPPR_WITH_ZSTD, link -lzstd)
+// when compiled in; zstd files made of several frames are decoded a
+// batch of frames at a time in parallel. Without those flags the file is
+// piped through the `gzip -dc` / `zstd -dc` command-line tools instead.
+class InputReader {
+    enum Format { PLAIN, GZIP, ZSTD };
+
+    AsyncBlockReader raw;
+    Format format = PLAIN;
+    string decoder_name;
+    FILE* pipe = nullptr;           // command-line decoder
+
+    // Decoded blocks waiting for the parser
+    static const size_t OUT_BLOCK = 4 << 20;
+    static const size_t MAX_QUEUED = 4;
+    deque<vector<char>> queued;
+    vector<char> current;
+    mutex m;
+    condition_variable cv;
+    bool finished = false, error = false, stopping = false;
+    thread decoder;
+
+    static bool endsWith(const string& s, const string& suffix) {
+        return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    // Hands one decoded block to the parser; false once close() was called
+    bool push(vector<char>&& block) {
+        if (block.empty()) return true;
+        Profiler::instance().addCounter("io.bytes_decoded", block.size());
+        unique_lock<mutex> lock(m);
+        cv.wait(lock, [&] { return stopping || queued.size() < MAX_QUEUED; });
+        if (stopping) return false;
+        queued.push_back(move(block));
+        cv.notify_all();
+        return true;
+    }
+
+    void finish(bool ok) {
+        lock_guard<mutex> lock(m);
+        finished = true;
+        error = error || !ok;
+        cv.notify_all();
+    }
+
+#ifdef PPR_WITH_ZLIB
+    // Inflates gzip / zlib data, including concatenated (multi-member) files
+    bool decodeGzip() {
+        z_stream zs;
+        memset(&zs, 0, sizeof(zs));
+        if (inflateInit2(&zs, 15 + 32) != Z_OK) return false;
+        vector<char> out(OUT_BLOCK);
+        size_t filled = 0;
+        int ret = Z_OK;
+        const char* data;
+        size_t got;
+        while (raw.next(data, got)) {
+            zs.next_in = (Bytef*)data;
+            zs.avail_in = got;
+            bool more = true;   // output may still be pending inside zlib
+            while (zs.avail_in > 0 || more) {
+                if (ret == Z_STREAM_END && zs.avail_in > 0) inflateReset(&zs);   // next member
+                zs.next_out = (Bytef*)out.data() + filled;
+                zs.avail_out = OUT_BLOCK - filled;
+                ret = inflate(&zs, Z_NO_FLUSH);
+                if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+                    inflateEnd(&zs);
+                    return false;
+                }
+                more = zs.avail_out == 0;
+                filled = OUT_BLOCK - zs.avail_out;
+                if (filled == OUT_BLOCK) {
+                    if (!push(move(out))) { inflateEnd(&zs); return true; }
+                    out = vector<char>(OUT_BLOCK);
+                    filled = 0;
+                }
+            }
+        }
+        inflateEnd(&zs);
+        out.resize(filled);
+        push(move(out));
+        return !raw.failed() && ret == Z_STREAM_END;
+    }
+#endif
+
+#ifdef PPR_WITH_ZSTD
+    // Frames larger than this are left to the streaming decoder, so a
+    // parallel batch holds at most threads x MAX_FRAME decoded bytes
+    static const size_t MAX_FRAME = 4 * OUT_BLOCK;
+
+    // One decoder thread per core for the whole file; worker t decodes
+    // frame t of each batch with its own reusable context
+    class ZstdBatchDecoder {
+        struct Frame {
+            const char* src = nullptr;
+            size_t len = 0;
+            vector<char> out;
+            bool ok = false;
+        };
+
+        vector<thread> workers;
+        mutex m;
+        condition_variable cv;
+        uint64_t batch = 0;
+        size_t pending = 0;
+        bool stopping = false;
+
+    public:
+        vector<Frame> frames;
+
+        explicit ZstdBatchDecoder(int threads) : frames(threads) {
+            for (int t = 0; t < threads; ++t)
+                workers.emplace_back([this, t] {
+                    ZSTD_DCtx* dctx = ZSTD_createDCtx();
+                    uint64_t seen = 0;
+                    while (true) {
+                        {
+                            unique_lock<mutex> lock(m);
+                            cv.wait(lock, [&] { return stopping || batch != seen; });
+                            if (stopping) break;
+                            seen = batch;
+                        }
+                        Frame& f = frames[t];
+                        if (f.src) {
+                            size_t n = ZSTD_decompressDCtx(dctx, f.out.data(), f.out.size(), f.src, f.len);
+                            f.ok = !ZSTD_isError(n) && n == f.out.size();
+                        }
+                        {
+                            lock_guard<mutex> lock(m);
+                            pending--;
+                        }
+                        cv.notify_all();
+                    }
+                    ZSTD_freeDCtx(dctx);
+                });
+        }
+
+        ~ZstdBatchDecoder() {
+            {
+                lock_guard<mutex> lock(m);
+                stopping = true;
+            }
+            cv.notify_all();
+            for (auto& w : workers) w.join();
+        }
+
+        // Decodes every frame with a non-null src; returns when all are done
+        void run() {
+            unique_lock<mutex> lock(m);
+            pending = workers.size();
+            batch++;
+            cv.notify_all();
+            cv.wait(lock, [&] { return pending == 0; });
+        }
+    };
+
+    // Complete frames are cut from the input and decoded in parallel
+    // batches (one frame per thread). Frames of unknown size or above
+    // MAX_FRAME, or an input with no frame boundary in sight, fall back to
+    // streaming decode.
+    bool decodeZstd() {
+        int threads = max(1u, thread::hardware_concurrency());
+        ZstdBatchDecoder batch(threads);
+        string in;
+        size_t in_pos = 0;
+        const char* data;
+        size_t got;
+        bool eof = false;
+        while (true) {
+            while (!eof && in.size() - in_pos < (size_t)threads * OUT_BLOCK) {
+                if (!raw.next(data, got)) { eof = true; break; }
+                in.append(data, got);
+            }
+            // Cut complete frames whose decoded size is known and bounded
+            size_t count = 0;
+            size_t pos = in_pos;
+            while ((int)count < threads && pos < in.size()) {
+                size_t len = ZSTD_findFrameCompressedSize(in.data() + pos, in.size() - pos);
+                unsigned long long content = ZSTD_getFrameContentSize(in.data() + pos, in.size() - pos);
+                if (ZSTD_isError(len) || content == ZSTD_CONTENTSIZE_UNKNOWN ||
+                    content == ZSTD_CONTENTSIZE_ERROR || content > MAX_FRAME)
+                    break;
+                auto& f = batch.frames[count++];
+                f.src = in.data() + pos;
+                f.len = len;
+                f.out.resize(content);
+                pos += len;
+            }
+            if (count == 0) {
+                if (in_pos == in.size() && eof) return !raw.failed();
+                return decodeZstdStream(in, in_pos);
+            }
+            for (size_t f = count; f < batch.frames.size(); ++f) batch.frames[f].src = nullptr;
+
+            batch.run();
+            for (size_t f = 0; f < count; ++f) {
+                const vector<char>& out = batch.frames[f].out;
+                if (!batch.frames[f].ok) return false;
+                // The parser queue holds OUT_BLOCK-sized blocks
+                for (size_t off = 0; off < out.size(); off += OUT_BLOCK) {
+                    size_t end = min(out.size(), off + OUT_BLOCK);
+                    if (!push(vector<char>(out.begin() + off, out.begin() + end))) return true;
+                }
+            }
+            in_pos = pos;
+            if (in_pos > (64 << 20)) {
+                in.erase(0, in_pos);
+                in_pos = 0;
+            }
+        }
+    }
+
+    // Streaming decode of everything from in[in_pos] on, plus the rest of the file
+    bool decodeZstdStream(string& in, size_t in_pos) {
+        ZSTD_DStream* ds = ZSTD_createDStream();
+        ZSTD_initDStream(ds);
+        vector<char> out(OUT_BLOCK);
+        auto feed = [&](const char* src, size_t len) {
+            ZSTD_inBuffer ib = {src, len, 0};
+            while (ib.pos < ib.size) {
+                ZSTD_outBuffer ob = {out.data(), out.size(), 0};
+                size_t r = ZSTD_decompressStream(ds, &ob, &ib);
+                if (ZSTD_isError(r)) return false;
+                if (!push(vector<char>(out.begin(), out.begin() + ob.pos))) return true;
+            }
+            return true;
+        };
+        bool ok = feed(in.data() + in_pos, in.size() - in_pos);
+        string().swap(in);
+        const char* data;
+        size_t got;
+        while (ok && raw.next(data, got)) ok = feed(data, got);
+        ZSTD_freeDStream(ds);
+        return ok && !raw.failed();
+    }
+#endif
+
+    // Single-quotes a path for the shell
+    static string shellQuote(const string& s) {
+        string q = "'";
+        for (char c : s) q += (c == '\'') ? string("'\\''") : string(1, c);
+        return q + "'";
+    }
+
+public:
+    InputReader() = default;
+    InputReader(const InputReader&) = delete;
+    InputReader& operator=(const InputReader&) = delete;
+    ~InputReader() { close(); }
+
+    bool open(const string& filename) {
+        format = endsWith(filename, ".gz") ? GZIP : endsWith(filename, ".zst") ? ZSTD : PLAIN;
+        if (format == PLAIN) return raw.open(filename);
+        if (access(filename.c_str(), R_OK) != 0) return false;
+
+#ifdef PPR_WITH_ZLIB
+        if (format == GZIP) {
+            decoder_name = "zlib";
+            if (!raw.open(filename)) return false;
+            decoder = thread([this] { ScopedTimer timer("io.decompress"); finish(decodeGzip()); });
+            return true;
+        }
+#endif
+#ifdef PPR_WITH_ZSTD
+        if (format == ZSTD) {
+            decoder_name = "zstd";
+            if (!raw.open(filename)) return false;
+            decoder = thread([this] { ScopedTimer timer("io.decompress"); finish(decodeZstd()); });
+            return true;
+        }
+#endif
+        decoder_name = (format == GZIP) ? "gzip -dc" : "zstd -dc";
+        pipe = popen((decoder_name + " " + shellQuote(filename)).c_str(), "r");
+        return pipe != nullptr;
+    }
+
+    string backend() const {
+        if (format == PLAIN) return raw.backend();
+        return pipe ? decoder_name : string(raw.backend()) + " + " + decoder_name;
+    }
+
+    bool failed() const { return error || raw.failed(); }
+
+    // Next decoded block, valid until the following call
+    bool next(const char*& data, size_t& size) {
+        if (format == PLAIN) return raw.next(data, size);
+        if (pipe) {
+            current.resize(OUT_BLOCK);
+            size = fread(current.data(), 1, current.size(), pipe);
+            data = current.data();
+            if (size > 0) Profiler::instance().addCounter("io.bytes_decoded", size);
+            return size > 0;
+        }
+        unique_lock<mutex> lock(m);
+        cv.wait(lock, [&] { return finished || !queued.empty(); });
+        if (queued.empty()) return false;
+        current = move(queued.front());
+        queued.pop_front();
+        cv.notify_all();
+        data = current.data();
+        size = current.size();
+        return true;
+    }
+
+    void close() {
+        if (pipe) {
+            int status = pclose(pipe);
+            pipe = nullptr;
+            if (status != 0) error = true;
+        }
+        if (decoder.joinable()) {
+            {
+                lock_guard<mutex> lock(m);
+                stopping = true;
+            }
+            cv.notify_all();
+            decoder.join();
+        }
+        raw.close();
+    }
+};
+
+// Calls fn(begin, end) for every line of the reader's remaining blocks
+template <typename Fn>
+static long long forEachLine(InputReader& reader, Fn fn) {
+    string pending;   // line split across two blocks
+    long long bytes = 0;
+    const char* data;
+    size_t got;
+    while (reader.next(data, got)) {
+        bytes += got;
+        const char* p = data;
+        const char* end = p + got;
+        while (true) {
+            const char* nl = (const char*)memchr(p, '\n', end - p);
+            if (!nl) {
+                pending.append(p, end);
+                break;
+            }
+            if (pending.empty()) {
+                fn(p, nl);
+            } else {
+                pending.append(p, nl);
+                fn(pending.data(), pending.data() + pending.size());
+                pending.clear();
+            }
+            p = nl + 1;
+        }
+    }
+    if (!pending.empty()) fn(pending.data(), pending.data() + pending.size());
+    return bytes;
+}
+
+// Splits the next whitespace-separated token off [p, end)
+static string_view nextToken(const char*& p, const char* end) {
+    auto space = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; };
+    while (p < end && space(*p)) ++p;
+    const char* start = p;
+    while (p < end && !space(*p)) ++p;
+    return string_view(start, p - start);
+}
+
+// Splits one line into endpoints and weight (robust to comments and blank
+// lines); returns false when the line holds no edge. With 'timestamp' set
+// a fourth column is read as the edge time; 'timestamp_ok' is cleared
+// when it is missing or not a number (the time is then 0).
+static bool parseEdgeLine(const char* line, const char* eol,
+                          string_view& u_str, string_view& v_str, double& weight,
+                          int64_t* timestamp = nullptr, bool* timestamp_ok = nullptr) {
+    if (line == eol || *line == '#' || *line == '%') return false;
+    u_str = nextToken(line, eol);
+    v_str = nextToken(line, eol);
+    if (v_str.empty()) return false;
+
+    // Optional third column: edge weight
+    weight = 1.0; // Default weight for unweighted graphs
+    string_view w_str = nextToken(line, eol);
+    if (!w_str.empty()) {
+        if (w_str[0] == '+') w_str.remove_prefix(1);
+        double w_in;
+        if (from_chars(w_str.data(), w_str.data() + w_str.size(), w_in).ec == errc())
+            weight = fabs(w_in);
+    }
+
+    // Prevent zero-weight edges (numerical stability)
+    if (weight == 0) weight = 0.0001;
+
+    if (timestamp) {
+        *timestamp = 0;
+        // Integer or decimal (rounded); either parse must use the whole token
+        string_view t_str = nextToken(line, eol);
+        const char* t_end = t_str.data() + t_str.size();
+        auto ti = from_chars(t_str.data(), t_end, *timestamp);
+        bool ok = !t_str.empty() && ti.ec == errc() && ti.ptr == t_end;
+        if (!ok) {
+            double t_in;
+            auto td = from_chars(t_str.data(), t_end, t_in);
+            ok = !t_str.empty() && td.ec == errc() && td.ptr == t_end && isfinite(t_in) &&
+                 fabs(t_in) < 9.2e18;
+            *timestamp = ok ? llround(t_in) : 0;
+        }
+        if (timestamp_ok) *timestamp_ok = ok;
+    }
+    return true;
+}
+
+struct LoadedEdge { int u, v; double w; };
+
+// How parallel (u,v) edges and self-loops are treated while building the CSR
+struct EdgePolicy {
+    enum Merge { NONE, SUM, MAX, COUNT };
+    Merge merge = NONE;          // NONE keeps every input line as its own edge
+    bool drop_self_loops = false;
+    bool active() const { return merge != NONE || drop_self_loops; }
+};
+
+struct RowEdge { int v; double w; int64_t t; };
+
+// Applies 'policy' to one row in place and returns its new length. Merged
+// rows come out sorted by (target, time); parallel weights fold in input
+// order, and COUNT replaces the weight by the multiplicity. Timed edges
+// ('times' set) only merge with edges of the same timestamp.
+static size_t compactRow(int row, int* cols, double* weights, int64_t* times, size_t len,
+                         const EdgePolicy& policy, vector<RowEdge>& scratch) {
+    scratch.clear();
+    for (size_t k = 0; k < len; ++k)
+        if (!policy.drop_self_loops || cols[k] != row)
+            scratch.push_back({cols[k], policy.merge == EdgePolicy::COUNT ? 1.0 : weights[k],
+                               times ? times[k] : 0});
+    if (policy.merge != EdgePolicy::NONE && scratch.size() > 1) {
+        stable_sort(scratch.begin(), scratch.end(), [](const RowEdge& a, const RowEdge& b) {
+            return a.v != b.v ? a.v < b.v : a.t < b.t;
+        });
+        size_t out = 0;
+        for (size_t k = 1; k < scratch.size(); ++k) {
+            if (scratch[k].v != scratch[out].v || scratch[k].t != scratch[out].t) {
+                scratch[++out] = scratch[k];
+                continue;
+            }
+            if (policy.merge == EdgePolicy::MAX) scratch[out].w = max(scratch[out].w, scratch[k].w);
+            else scratch[out].w += scratch[k].w;
+        }
+        scratch.resize(out + 1);
+    }
+    for (size_t k = 0; k < scratch.size(); ++k) {
+        cols[k] = scratch[k].v;
+        weights[k] = scratch[k].w;
+        if (times) times[k] = scratch[k].t;
+    }
+    return scratch.size();
+}
+
+// Integer ids: number nodes by first occurrence (as the string path
+// does) via a direct array when the values are dense, otherwise via
+// the rank of each value among the sorted distinct values.
+static void remapNumericIds(vector<int64_t>& raw_ids, vector<double>& raw_weights,
+                            vector<LoadedEdge>& edges, NodeMapper& mapper) {
+    ScopedTimer timer("load.numeric_remap");
+    int64_t max_val = *max_element(raw_ids.begin(), raw_ids.end());
+    vector<int64_t> names;
+    edges.resize(raw_weights.size());
+
+    if (max_val <= 4 * (int64_t)raw_ids.size() + (1 << 20)) {
+        vector<int> id_of(max_val + 1, -1);
+        auto idOf = [&](int64_t v) {
+            if (id_of[v] < 0) { id_of[v] = names.size(); names.push_back(v); }
+            return id_of[v];
+        };
+        for (size_t e = 0; e < raw_weights.size(); ++e)
+            edges[e] = {idOf(raw_ids[2 * e]), idOf(raw_ids[2 * e + 1]), raw_weights[e]};
+    } else {
+        vector<int64_t> sorted_vals(raw_ids);
+        sort(sorted_vals.begin(), sorted_vals.end());
+        sorted_vals.erase(unique(sorted_vals.begin(), sorted_vals.end()), sorted_vals.end());
+        vector<int> id_of(sorted_vals.size(), -1);
+        auto idOf = [&](int64_t v) {
+            size_t rank = lower_bound(sorted_vals.begin(), sorted_vals.end(), v) - sorted_vals.begin();
+            if (id_of[rank] < 0) { id_of[rank] = names.size(); names.push_back(v); }
+            return id_of[rank];
+        };
+        for (size_t e = 0; e < raw_weights.size(); ++e)
+            edges[e] = {idOf(raw_ids[2 * e]), idOf(raw_ids[2 * e + 1]), raw_weights[e]};
+    }
+    vector<int64_t>().swap(raw_ids);
+    vector<double>().swap(raw_weights);
+    mapper.assignNumericNames(move(names));
+}
+
+// Counting sort by source keeps each row in input order. 'times' (one
+// timestamp per edge, in input order) makes the graph temporal.
+static CSRGraph buildCSR(int N, const vector<LoadedEdge>& edges, const EdgePolicy& policy,
+                         const vector<int64_t>* times = nullptr) {
+    ScopedTimer timer("load.csr_build");
+    CSRGraph graph(N);
+    graph.num_edges = edges.size();
+    graph.col_indices.resize(graph.num_edges);
+    graph.edge_weights.resize(graph.num_edges);
+    if (times) graph.edge_times.resize(graph.num_edges);
+
+    for (const auto& e : edges) graph.row_ptr[e.u + 1]++;
+    for (int i = 0; i < N; ++i) graph.row_ptr[i + 1] += graph.row_ptr[i];
+
+    vector<int> cursor(graph.row_ptr.begin(), graph.row_ptr.end() - 1);
+    for (size_t e = 0; e < edges.size(); ++e) {
+        int pos = cursor[edges[e].u]++;
+        graph.col_indices[pos] = edges[e].v;
+        graph.edge_weights[pos] = edges[e].w;
+        if (times) graph.edge_times[pos] = (*times)[e];
+    }
+    if (policy.active()) {
+        // Rows only shrink, so each compacted row slides down in place
+        ScopedTimer merge_timer("load.edge_merge");
+        vector<RowEdge> scratch;
+        int write = 0;
+        for (int i = 0; i < N; ++i) {
+            int begin = graph.row_ptr[i], len = graph.row_ptr[i + 1] - begin;
+            size_t kept = compactRow(i, &graph.col_indices[begin], &graph.edge_weights[begin],
+                                     times ? &graph.edge_times[begin] : nullptr, len, policy, scratch);
+            if (write != begin) {
+                move(graph.col_indices.begin() + begin, graph.col_indices.begin() + begin + kept,
+                     graph.col_indices.begin() + write);
+                move(graph.edge_weights.begin() + begin, graph.edge_weights.begin() + begin + kept,
+                     graph.edge_weights.begin() + write);
+                if (times)
+                    move(graph.edge_times.begin() + begin, graph.edge_times.begin() + begin + kept,
+                         graph.edge_times.begin() + write);
+            }
+            graph.row_ptr[i] = write;
+            write += kept;
+        }
+        graph.row_ptr[N] = write;
+        Profiler::instance().addCounter("load.edges_merged", graph.num_edges - write);
+        graph.num_edges = write;
+        graph.col_indices.resize(write);
+        graph.edge_weights.resize(write);
+        graph.col_indices.shrink_to_fit();
+        graph.edge_weights.shrink_to_fit();
+        if (times) {
+            graph.edge_times.resize(write);
+            graph.edge_times.shrink_to_fit();
+        }
+    }
+    if (times) graph.base_weights = graph.edge_weights;
+    for (int i = 0; i < N; ++i) {
+        double sum_w = 0.0;
+        for (int k = graph.row_ptr[i]; k < graph.row_ptr[i + 1]; ++k) sum_w += graph.edge_weights[k];
+        graph.out_weight_sum[i] = sum_w;
+    }
+    return graph;
+}
+
+// Thread-safe name interning for parallel ingestion. Names are spread by
+// hash over 64 independently locked shards, so parser threads rarely
+// contend. Ids are provisional (local id << 6 | shard) and depend on
+// thread timing until canonicalize() renumbers them.
+class ConcurrentNodeMapper {
+    static const int SHARD_BITS = 6;
+    struct alignas(64) Shard {
+        mutex m;
+        NodeMapper names;
+    };
+    vector<Shard> shards;
+
+public:
+    ConcurrentNodeMapper() : shards(1 << SHARD_BITS) {}
+
+    int getId(string_view name) {
+        int s = hashNodeName(name) >> (64 - SHARD_BITS);
+        Shard& shard = shards[s];
+        lock_guard<mutex> lock(shard.m);
+        return (shard.names.getId(name) << SHARD_BITS) | s;
+    }
+
+    void appendName(string& out, int id) const {
+        shards[id & ((1 << SHARD_BITS) - 1)].names.appendName(out, id >> SHARD_BITS);
+    }
+
+    // Exclusive upper bound of the provisional ids handed out so far
+    int idBound() const {
+        int bound = 0;
+        for (int s = 0; s < (int)shards.size(); ++s)
+            bound = max(bound, (shards[s].names.getNumNodes() << SHARD_BITS) | s);
+        return bound + 1;
+    }
+
+    // Deterministic renumbering (call after all inserts): rewrites 'ids' in
+    // order of first appearance and installs the names into the empty
+    // 'mapper' in that order, matching what a single-threaded pass would
+    // produce. Every step runs on 'threads' threads over slices of 'ids'
+    // or of the canonical id range:
+    //   1. first position of each provisional id (atomic min),
+    //   2. first positions counted per slice and prefix-summed into ranks,
+    //   3. names copied per canonical range, hash table filled with CAS.
+    void canonicalize(vector<int>& ids, NodeMapper& mapper, int threads = 1) const {
+        ScopedTimer timer("load.canonicalize");
+        size_t n = ids.size();
+        threads = max(1, (int)min<size_t>(threads, max<size_t>(n, 1)));
+        auto parallel = [threads](auto fn) {
+            vector<thread> workers;
+            for (int t = 0; t < threads; ++t) workers.emplace_back([&fn, t] { fn(t); });
+            for (auto& w : workers) w.join();
+        };
+        auto sliceBegin = [&](int t, size_t count) { return count * t / threads; };
+
+        vector<uint64_t> first(idBound(), UINT64_MAX);
+        parallel([&](int t) {
+            for (size_t pos = sliceBegin(t, n); pos < sliceBegin(t + 1, n); ++pos) {
+                uint64_t* slot = &first[ids[pos]];
+                uint64_t cur = __atomic_load_n(slot, __ATOMIC_RELAXED);
+                while (pos < cur && !__atomic_compare_exchange_n(slot, &cur, pos, false,
+                                                                 __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+            }
+        });
+
+        vector<size_t> base(threads + 1, 0);
+        parallel([&](int t) {
+            size_t count = 0;
+            for (size_t pos = sliceBegin(t, n); pos < sliceBegin(t + 1, n); ++pos)
+                count += first[ids[pos]] == pos;
+            base[t + 1] = count;
+        });
+        for (int t = 0; t < threads; ++t) base[t + 1] += base[t];
+        size_t K = base[threads];
+
+        vector<int> canon(first.size()), provisional(K);
+        parallel([&](int t) {
+            size_t c = base[t];
+            for (size_t pos = sliceBegin(t, n); pos < sliceBegin(t + 1, n); ++pos)
+                if (first[ids[pos]] == pos) {
+                    canon[ids[pos]] = c;
+                    provisional[c++] = ids[pos];
+                }
+        });
+        vector<uint64_t>().swap(first);
+        parallel([&](int t) {
+            for (size_t pos = sliceBegin(t, n); pos < sliceBegin(t + 1, n); ++pos) ids[pos] = canon[ids[pos]];
+        });
+
+        vector<string> parts(threads);
+        vector<uint64_t> ends(K + 1, 0);
+        parallel([&](int t) {
+            for (size_t c = sliceBegin(t, K); c < sliceBegin(t + 1, K); ++c) {
+                appendName(parts[t], provisional[c]);
+                ends[c + 1] = parts[t].size();
+            }
+        });
+        string names;
+        vector<size_t> part_base(threads + 1, 0);
+        for (int t = 0; t < threads; ++t) part_base[t + 1] = part_base[t] + parts[t].size();
+        names.resize(part_base[threads]);
+        parallel([&](int t) {
+            memcpy(&names[part_base[t]], parts[t].data(), parts[t].size());
+            string().swap(parts[t]);
+            for (size_t c = sliceBegin(t, K); c < sliceBegin(t + 1, K); ++c) ends[c + 1] += part_base[t];
+        });
+        mapper.assignArenaNames(move(names), move(ends), threads);
+    }
+};
+
+// Parallel ingestion of an edge list into an empty mapper. Blocks from
+// the reader are cut at line boundaries into chunks and handed to the
+// parser threads through a bounded queue, so reading overlaps parsing and
+// only a few chunks of text are resident at a time. A chunk keeps raw
+// integer ids while every id in it is numeric and interns names through
+// a ConcurrentNodeMapper otherwise. Ids are canonicalized by first
+// occurrence, so the result is identical to the single-threaded loader.
+// With 'times' set, returns the number of edges without a valid timestamp.
+static size_t parseEdgesParallel(InputReader& reader, int threads, NodeMapper& mapper,
+                                 vector<LoadedEdge>& edges, vector<int64_t>* times,
+                                 long long& bytes_read) {
+    struct Chunk {
+        string text;                // whole lines, freed once parsed
+        vector<int64_t> raw_ids;    // u, v pairs while every id is numeric
+        vector<int> ids;            // provisional u, v ids otherwise
+        vector<double> weights;
+        vector<int64_t> times;
+        size_t bad_times = 0;
+        bool numeric = true;
+        size_t first_edge = 0;
+    };
+    deque<Chunk> chunks;            // stable references while growing
+    ConcurrentNodeMapper names;
+    bool timed = times != nullptr;
+
+    // Names the chunk's numeric ids so far and switches it to interning
+    auto internRaw = [&names](Chunk& c) {
+        char buf[24];
+        c.ids.resize(c.raw_ids.size());
+        for (size_t k = 0; k < c.raw_ids.size(); ++k) {
+            auto r = to_chars(buf, buf + sizeof(buf), c.raw_ids[k]);
+            c.ids[k] = names.getId(string_view(buf, r.ptr - buf));
+        }
+        vector<int64_t>().swap(c.raw_ids);
+        c.numeric = false;
+    };
+
+    auto parseChunk = [&](Chunk& c) {
+        const char* p = c.text.data();
+        const char* end = p + c.text.size();
+        while (p < end) {
+            const char* eol = (const char*)memchr(p, '\n', end - p);
+            if (!eol) eol = end;
+            string_view u_str, v_str;
+            double weight;
+            int64_t t;
+            bool t_ok = true;
+            if (parseEdgeLine(p, eol, u_str, v_str, weight, timed ? &t : nullptr, &t_ok)) {
+                if (timed) c.times.push_back(t);
+                c.bad_times += !t_ok;
+                c.weights.push_back(weight);
+                int64_t u_val, v_val;
+                if (c.numeric && NodeMapper::parseNumericName(u_str, u_val) &&
+                    NodeMapper::parseNumericName(v_str, v_val)) {
+                    c.raw_ids.push_back(u_val);
+                    c.raw_ids.push_back(v_val);
+                } else {
+                    if (c.numeric) internRaw(c);
+                    c.ids.push_back(names.getId(u_str));
+                    c.ids.push_back(names.getId(v_str));
+                }
+            }
+            p = eol + 1;
+        }
+        string().swap(c.text);
+    };
+
+    // Bounded queue between the reading thread and the parsers
+    const size_t max_pending = 2 * threads;
+    deque<Chunk*> queue;
+    size_t in_flight = 0;           // queued or being parsed
+    bool done = false;
+    mutex m;
+    condition_variable cv;
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back([&] {
+            while (true) {
+                Chunk* c;
+                {
+                    unique_lock<mutex> lock(m);
+                    cv.wait(lock, [&] { return done || !queue.empty(); });
+                    if (queue.empty()) return;
+                    c = queue.front();
+                    queue.pop_front();
+                }
+                parseChunk(*c);
+                {
+                    lock_guard<mutex> lock(m);
+                    in_flight--;
+                }
+                cv.notify_all();
+            }
+        });
+
+    {
+        ScopedTimer timer("load.parse");
+        auto submit = [&](string&& text) {
+            unique_lock<mutex> lock(m);
+            cv.wait(lock, [&] { return in_flight < max_pending; });
+            chunks.emplace_back();
+            chunks.back().text = move(text);
+            queue.push_back(&chunks.back());
+            in_flight++;
+            cv.notify_all();
+        };
+        string carry;   // line split across two blocks
+        const char* data;
+        size_t got;
+        bytes_read = 0;
+        while (reader.next(data, got)) {
+            bytes_read += got;
+            const char* last_nl = (const char*)memrchr(data, '\n', got);
+            if (!last_nl) {
+                carry.append(data, got);
+                continue;
+            }
+            string text;
+            text.reserve(carry.size() + (last_nl + 1 - data));
+            text.append(carry).append(data, last_nl + 1);
+            carry.assign(last_nl + 1, data + got);
+            submit(move(text));
+        }
+        if (!carry.empty()) submit(move(carry));
+        {
+            lock_guard<mutex> lock(m);
+            done = true;
+        }
+        cv.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    size_t total = 0, bad_times = 0;
+    bool numeric = true;
+    for (Chunk& c : chunks) {
+        c.first_edge = total;
+        total += c.weights.size();
+        bad_times += c.bad_times;
+        numeric = numeric && c.numeric;
+    }
+    if (total == 0) return bad_times;
+    if (times) {
+        times->resize(total);
+        for (Chunk& c : chunks) {
+            copy(c.times.begin(), c.times.end(), times->begin() + c.first_edge);
+            vector<int64_t>().swap(c.times);
+        }
+    }
+
+    if (numeric) {
+        vector<int64_t> raw_ids(2 * total);
+        vector<double> raw_weights(total);
+        for (Chunk& c : chunks) {
+            copy(c.raw_ids.begin(), c.raw_ids.end(), raw_ids.begin() + 2 * c.first_edge);
+            copy(c.weights.begin(), c.weights.end(), raw_weights.begin() + c.first_edge);
+            vector<int64_t>().swap(c.raw_ids);
+            vector<double>().swap(c.weights);
+        }
+        remapNumericIds(raw_ids, raw_weights, edges, mapper);
+        return bad_times;
+    }
+
+    // Chunks that stayed numeric still need their ids named
+    {
+        ScopedTimer timer("load.intern");
+        size_t next_chunk = 0;
+        vector<thread> interns;
+        for (int t = 0; t < threads; ++t)
+            interns.emplace_back([&] {
+                for (size_t k; (k = __atomic_fetch_add(&next_chunk, 1, __ATOMIC_RELAXED)) < chunks.size();)
+                    if (chunks[k].numeric) internRaw(chunks[k]);
+            });
+        for (auto& w : interns) w.join();
+    }
+    vector<int> ids(2 * total);
+    for (Chunk& c : chunks) {
+        copy(c.ids.begin(), c.ids.end(), ids.begin() + 2 * c.first_edge);
+        vector<int>().swap(c.ids);
+    }
+    names.canonicalize(ids, mapper, threads);
+
+    edges.resize(total);
+    for (const Chunk& c : chunks)
+        for (size_t k = 0; k < c.weights.size(); ++k) {
+            size_t e = c.first_edge + k;
+            edges[e] = {ids[2 * e], ids[2 * e + 1], c.weights[k]};
+        }
+    return bad_times;
+}
+
+// threads > 1 parses in parallel (only while the mapper is still empty)
+// 'temporal' reads a timestamp column (u v w t) into the graph's edge_times.
+CSRGraph loadGraphFromFile(const string& filename, NodeMapper& mapper, int threads = 1,
+                           const EdgePolicy& policy = EdgePolicy(), bool temporal = false) {
+    InputReader reader;
+    if (!reader.open(filename)) {
+        cerr << "Error: File '" << filename << "' not found!" << endl;
+        exit(1);
+    }
+
+    vector<LoadedEdge> temp_edges;
+    vector<int64_t> times;     // per edge, in input order, when temporal
+    size_t bad_times = 0;      // temporal edges whose timestamp was missing or invalid
+    long long bytes_read = 0;
+    bool had_dictionary = mapper.hasDictionary();
+
+    cout << "[Loader] Reading dataset (" << reader.backend() << ")..." << endl;
+
+    // While every id seen so far is a plain integer, edges keep the raw
+    // values and skip string hashing; the first non-numeric id replays
+    // them through the string mapper.
+    bool numeric = mapper.getNumNodes() == 0;
+    vector<int64_t> raw_ids;   // u, v pairs while numeric
+    vector<double> raw_weights;
+
+    if (threads > 1 && mapper.getNumNodes() != 0)
+        cout << "[Loader] Mapper already holds names (dictionary): parsing on one thread" << endl;
+    if (threads > 1 && mapper.getNumNodes() == 0) {
+        bad_times = parseEdgesParallel(reader, threads, mapper, temp_edges, temporal ? &times : nullptr,
+                                       bytes_read);
+        numeric = false;
+    } else {
+        // Blocks stream in while earlier ones are parsed
+        ScopedTimer timer("load.parse");
+        bytes_read = forEachLine(reader, [&](const char* line, const char* eol) {
+            string_view u_str, v_str;
+            double weight;
+            int64_t t;
+            bool t_ok = true;
+            if (!parseEdgeLine(line, eol, u_str, v_str, weight, temporal ? &t : nullptr, &t_ok)) return;
+            if (temporal) times.push_back(t);
+            bad_times += !t_ok;
+
+            if (numeric) {
+                int64_t u_val, v_val;
+                if (NodeMapper::parseNumericName(u_str, u_val) &&
+                    NodeMapper::parseNumericName(v_str, v_val)) {
+                    raw_ids.push_back(u_val);
+                    raw_ids.push_back(v_val);
+                    raw_weights.push_back(weight);
+                    return;
+                }
+                numeric = false;
+                char a[24], b[24];
+                for (size_t e = 0; e < raw_weights.size(); ++e) {
+                    auto ra = to_chars(a, a + sizeof(a), raw_ids[2 * e]);
+                    auto rb = to_chars(b, b + sizeof(b), raw_ids[2 * e + 1]);
+                    int u = mapper.getId(string_view(a, ra.ptr - a));
+                    int v = mapper.getId(string_view(b, rb.ptr - b));
+                    temp_edges.push_back({u, v, raw_weights[e]});
+                }
+                vector<int64_t>().swap(raw_ids);
+                vector<double>().swap(raw_weights);
+            }
+
+            int u = mapper.getId(u_str);
+            int v = mapper.getId(v_str);
+            temp_edges.push_back({u, v, weight});
+        });
+    }
+    reader.close();
+    if (reader.failed()) {
+        cerr << "Error: read failure in '" << filename << "'" << endl;
+        exit(1);
+    }
+    if (bad_times > 0)
+        cerr << "Warning: " << bad_times << " edge line(s) without a valid timestamp; they were given time 0" << endl;
+
+    if (numeric && !raw_weights.empty())
+        remapNumericIds(raw_ids, raw_weights, temp_edges, mapper);
+
+    // A dictionary from a larger or older graph would leave its unused
+    // names as isolated phantom nodes: renumber by first occurrence, as
+    // without a dictionary, and let the caller rebuild it
+    if (had_dictionary) {
+        int N = mapper.getNumNodes();
+        vector<int> remap(N, -1);
+        string names;
+        vector<size_t> ends;
+        for (const auto& e : temp_edges)
+            for (int id : {e.u, e.v})
+                if (remap[id] < 0) {
+                    remap[id] = ends.size();
+                    mapper.appendName(names, id);
+                    ends.push_back(names.size());
+                }
+        if ((int)ends.size() < N) {
+            cout << "[Dict] " << N - (int)ends.size() << " dictionary names are not in the graph; renumbering without it" << endl;
+            mapper.clear();
+            for (size_t k = 0; k < ends.size(); ++k) {
+                size_t begin = k ? ends[k - 1] : 0;
+                mapper.getId(string_view(names.data() + begin, ends[k] - begin));
+            }
+            for (auto& e : temp_edges) {
+                e.u = remap[e.u];
+                e.v = remap[e.v];
+            }
+        }
+    }
+
+    Profiler& prof = Profiler::instance();
+    prof.addCounter("load.bytes_read", bytes_read);
+    prof.addCounter("load.edges_parsed", temp_edges.size());
+    prof.addCounter("mapper.nodes", mapper.getNumNodes());
+    prof.addCounter("mapper.bytes", mapper.memoryBytes());
+
+    return buildCSR(mapper.getNumNodes(), temp_edges, policy, temporal ? &times : nullptr);
+}
+
+// =========================================================
+// Out-of-Core CSR Construction (Edge Lists Larger Than RAM)
+// =========================================================
+
+// Only the O(N) node state (names, degrees, out-weights) stays in memory.
+// Edges are buffered up to the memory budget, stable-sorted by source and
+// spilled as runs; a k-way merge then writes the CSR arrays straight into
+// the snapshot. Runs are merged in file order and each run is stable, so
+// rows keep input order and the snapshot equals the in-memory CSR.
+//
+// Snapshot layout (little-endian, every section 8-byte aligned):
+//   char     magic[8]          "PPRCSR2"
+//   uint64   num_nodes, num_edges
+//   uint32   edge_merge, drop_self_loops   EdgePolicy the edges were built with
+//   int64    row_ptr[num_nodes + 1]
+//   int32    col_indices[num_edges]
+//   double   edge_weights[num_edges]
+//   double   out_weight_sum[num_nodes]
+// Node names are saved next to it as a NodeDictionary (<snapshot>.dict).
+struct CSRSnapshotHeader {
+    char magic[8];
+    uint64_t num_nodes;
+    uint64_t num_edges;
+    uint32_t edge_merge;
+    uint32_t drop_self_loops;
+};
+
+// A snapshot is only reused with the edge policy it was built with
+static bool snapshotPolicyMatches(const CSRSnapshotHeader& hdr, const EdgePolicy& policy) {
+    if (hdr.edge_merge == (uint32_t)policy.merge && hdr.drop_self_loops == (uint32_t)policy.drop_self_loops)
+        return true;
+    cerr << "Error: snapshot was built with a different --merge-edges / --self-loops policy" << endl;
+    return false;
+}
+
+struct CSRSnapshotLayout {
+    uint64_t num_nodes, num_edges;
+    uint64_t row_ptr_off, col_off, weight_off, out_sum_off, file_size;
+
+    CSRSnapshotLayout(uint64_t n, uint64_t e) : num_nodes(n), num_edges(e) {
+        auto align8 = [](uint64_t b) { return (b + 7) & ~(uint64_t)7; };
+        row_ptr_off = align8(sizeof(CSRSnapshotHeader));
+        col_off = row_ptr_off + align8((n + 1) * sizeof(int64_t));
+        weight_off = col_off + align8(e * sizeof(int32_t));
+        out_sum_off = weight_off + align8(e * sizeof(double));
+        file_size = out_sum_off + align8(n * sizeof(double));
+    }
+};
+
+// Buffered positional writer for one section of the snapshot
+class SectionWriter {
+    int fd;
+    uint64_t offset;
+    vector<char> buf;
+    size_t used = 0;
+
+public:
+    SectionWriter(int fd, uint64_t offset, size_t buffer_bytes)
+        : fd(fd), offset(offset), buf(max<size_t>(buffer_bytes, 1 << 16)) {}
+
+    bool flush() {
+        size_t done = 0;
+        while (done < used) {
+            ssize_t n = pwrite(fd, buf.data() + done, used - done, offset + done);
+            if (n <= 0) return false;
+            done += n;
+        }
+        offset += used;
+        used = 0;
+        return true;
+    }
+
+    bool write(const void* data, size_t bytes) {
+        if (used + bytes > buf.size() && !flush()) return false;
+        memcpy(buf.data() + used, data, bytes);
+        used += bytes;
+        return true;
+    }
+};
+
+// Builds a CSR snapshot of 'edge_file' using at most about
+// memory_budget_bytes for edge buffers; names go into 'mapper'. The
+// budget does not cover the names: 'mapper' (and the O(N) degree and
+// out-weight arrays) stay resident for the whole build.
+bool buildCSRSnapshot(const string& edge_file, const string& snapshot_file,
+                      NodeMapper& mapper, size_t memory_budget_bytes, const string& tmp_dir,
+                      const EdgePolicy& policy = EdgePolicy()) {
+    InputReader reader;
+    if (!reader.open(edge_file)) {
+        cerr << "Error: File '" << edge_file << "' not found!" << endl;
+        return false;
+    }
+    cout << "[Snapshot] Building " << snapshot_file << " out of core (budget "
+         << (memory_budget_bytes >> 20) << " MB)..." << endl;
+
+    size_t run_capacity = max<size_t>(memory_budget_bytes / sizeof(LoadedEdge), 1024);
+    vector<LoadedEdge> buffer;
+    buffer.reserve(min<size_t>(run_capacity, 1 << 20));
+    vector<string> runs;
+    vector<uint64_t> degree;
+    uint64_t num_edges = 0;
+    bool ok = true;
+
+    auto spill = [&]() {
+        if (buffer.empty()) return;
+        ScopedTimer timer("snapshot.spill");
+        stable_sort(buffer.begin(), buffer.end(),
+                    [](const LoadedEdge& a, const LoadedEdge& b) { return a.u < b.u; });
+        string name = tmp_dir + "/ppr_run_" + to_string(getpid()) + "_" + to_string(runs.size()) + ".bin";
+        ofstream out(name, ios::binary);
+        out.write((const char*)buffer.data(), buffer.size() * sizeof(LoadedEdge));
+        ok = ok && out.good();
+        runs.push_back(name);
+        buffer.clear();
+    };
+
+    // Pass 1: parse, count degrees and spill sorted runs
+    long long bytes_read;
+    {
+        ScopedTimer timer("snapshot.parse");
+        bytes_read = forEachLine(reader, [&](const char* line, const char* eol) {
+            string_view u_str, v_str;
+            double weight;
+            if (!parseEdgeLine(line, eol, u_str, v_str, weight)) return;
+            int u = mapper.getId(u_str);
+            int v = mapper.getId(v_str);
+            if ((size_t)mapper.getNumNodes() > degree.size())
+                degree.resize(max<size_t>(mapper.getNumNodes(), degree.size() * 2), 0);
+            degree[u]++;
+            num_edges++;
+            buffer.push_back({u, v, weight});
+            if (buffer.size() >= run_capacity) spill();
+        });
+        spill();
+        reader.close();
+        ok = ok && !reader.failed();
+    }
+    size_t spilled_runs = runs.size();   // the compaction pass below replaces them
+
+    // Streams the edges of all runs in (source, file) order
+    auto mergeRuns = [&](auto&& emit) {
+        struct RunReader {
+            ifstream in;
+            vector<LoadedEdge> buf;
+            size_t pos = 0;
+            bool next(LoadedEdge& e) {
+                if (pos == buf.size()) {
+                    buf.resize(buf.capacity());
+                    in.read((char*)buf.data(), buf.size() * sizeof(LoadedEdge));
+                    buf.resize(in.gcount() / sizeof(LoadedEdge));
+                    pos = 0;
+                    if (buf.empty()) return false;
+                }
+                e = buf[pos++];
+                return true;
+            }
+        };
+        size_t k = runs.size();
+        size_t reader_records = max<size_t>(memory_budget_bytes / 2 / max<size_t>(k, 1) / sizeof(LoadedEdge), 4096);
+        vector<RunReader> readers(k);
+        // Min-heap on (source, run index): equal sources drain in run (file) order
+        priority_queue<pair<int, size_t>, vector<pair<int, size_t>>, greater<pair<int, size_t>>> heap;
+        vector<LoadedEdge> head(k);
+        for (size_t r = 0; r < k; ++r) {
+            readers[r].in.open(runs[r], ios::binary);
+            readers[r].buf.reserve(reader_records);
+            if (readers[r].next(head[r])) heap.push({head[r].u, r});
+        }
+
+        while (!heap.empty() && ok) {
+            size_t r = heap.top().second;
+            heap.pop();
+            emit(head[r]);
+            if (readers[r].next(head[r])) heap.push({head[r].u, r});
+        }
+    };
+
+    // Optional pass: fold parallel edges / self-loops row by row into a
+    // single compacted run, which also fixes the degrees and edge count
+    uint64_t edges_parsed = num_edges;
+    if (ok && policy.active()) {
+        ScopedTimer timer("snapshot.edge_merge");
+        string name = tmp_dir + "/ppr_run_" + to_string(getpid()) + "_merged.bin";
+        ofstream out(name, ios::binary);
+        vector<int> cols;
+        vector<double> weights;
+        vector<RowEdge> scratch;
+        int row = -1;
+        num_edges = 0;
+        auto flushRow = [&]() {
+            if (row < 0) return;
+            size_t kept = compactRow(row, cols.data(), weights.data(), nullptr, cols.size(), policy, scratch);
+            buffer.clear();
+            for (size_t k = 0; k < kept; ++k) buffer.push_back({row, cols[k], weights[k]});
+            out.write((const char*)buffer.data(), buffer.size() * sizeof(LoadedEdge));
+            degree[row] = kept;
+            num_edges += kept;
+            cols.clear();
+            weights.clear();
+        };
+        mergeRuns([&](const LoadedEdge& e) {
+            if (e.u != row) { flushRow(); row = e.u; }
+            cols.push_back(e.v);
+            weights.push_back(e.w);
+        });
+        flushRow();
+        out.close();
+        ok = ok && out.good();
+        for (const string& r : runs) remove(r.c_str());
+        runs.assign(1, name);
+        vector<LoadedEdge>().swap(buffer);
+    }
+
+    uint64_t N = mapper.getNumNodes();
+    CSRSnapshotLayout layout(N, num_edges);
+    int fd = open(snapshot_file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    ok = ok && fd >= 0 && ftruncate(fd, layout.file_size) == 0;
+
+    // Pass 2: header and row_ptr from the degrees, then k-way merge of the runs
+    if (ok) {
+        ScopedTimer timer("snapshot.merge");
+        size_t section_buffer = max<size_t>(memory_budget_bytes / 4, 1 << 16);
+        SectionWriter header_out(fd, 0, sizeof(CSRSnapshotHeader));
+        CSRSnapshotHeader hdr = {{'P', 'P', 'R', 'C', 'S', 'R', '2', 0}, N, num_edges,
+                                 (uint32_t)policy.merge, (uint32_t)policy.drop_self_loops};
+        ok = header_out.write(&hdr, sizeof(hdr)) && header_out.flush();
+
+        SectionWriter row_out(fd, layout.row_ptr_off, section_buffer);
+        int64_t offset = 0;
+        for (uint64_t i = 0; i <= N && ok; ++i) {
+            ok = row_out.write(&offset, sizeof(offset));
+            if (i < N) offset += degree[i];
+        }
+        ok = ok && row_out.flush();
+        vector<uint64_t>().swap(degree);
+
+        SectionWriter col_out(fd, layout.col_off, section_buffer / 2);
+        SectionWriter weight_out(fd, layout.weight_off, section_buffer);
+        vector<double> out_weight_sum(N, 0.0);
+        mergeRuns([&](const LoadedEdge& e) {
+            int32_t col = e.v;
+            ok = col_out.write(&col, sizeof(col)) && weight_out.write(&e.w, sizeof(e.w));
+            out_weight_sum[e.u] += e.w;
+        });
+        ok = ok && col_out.flush() && weight_out.flush();
+
+        SectionWriter sum_out(fd, layout.out_sum_off, sizeof(double) * N);
+        ok = ok && sum_out.write(out_weight_sum.data(), sizeof(double) * N) && sum_out.flush();
+    }
+    if (fd >= 0) close(fd);
+    for (const string& r : runs) remove(r.c_str());
+
+    ok = ok && mapper.saveDictionary(snapshot_file + ".dict");
+    Profiler& prof = Profiler::instance();
+    prof.addCounter("snapshot.bytes_read", bytes_read);
+    prof.addCounter("snapshot.runs", spilled_runs);
+    prof.addCounter("snapshot.edges", num_edges);
+    if (policy.active()) prof.addCounter("snapshot.edges_merged", edges_parsed - num_edges);
+    if (!ok) {
+        // A partial snapshot at this path would be reused by the next run
+        unlink(snapshot_file.c_str());
+        unlink((snapshot_file + ".dict").c_str());
+        cerr << "Error: could not write snapshot '" << snapshot_file << "'" << endl;
+    } else cout << "[Snapshot] " << N << " nodes, " << num_edges << " edges, "
+              << spilled_runs << " sorted run(s)" << endl;
+    return ok;
+}
+
+// Loads a snapshot fully into memory and maps its node dictionary; it must
+// have been built with 'policy'
+bool loadCSRSnapshot(const string& snapshot_file, NodeMapper& mapper, CSRGraph& graph,
+                     const EdgePolicy& policy = EdgePolicy()) {
+    ifstream file(snapshot_file, ios::binary);
+    CSRSnapshotHeader hdr;
+    if (!file.read((char*)&hdr, sizeof(hdr)) || memcmp(hdr.magic, "PPRCSR2", 8) != 0) return false;
+    if (!snapshotPolicyMatches(hdr, policy)) return false;
+    if (hdr.num_edges > (uint64_t)INT32_MAX || hdr.num_nodes >= (uint64_t)INT32_MAX) {
+        cerr << "Error: snapshot has too many nodes or edges to load into memory" << endl;
+        return false;
+    }
+    if (!mapper.loadDictionary(snapshot_file + ".dict") ||
+        (uint64_t)mapper.getNumNodes() != hdr.num_nodes) return false;
+
+    ScopedTimer timer("snapshot.load");
+    CSRSnapshotLayout layout(hdr.num_nodes, hdr.num_edges);
+    int N = hdr.num_nodes;
+    graph = CSRGraph(N);
+    graph.num_edges = hdr.num_edges;
+    graph.col_indices.resize(graph.num_edges);
+    graph.edge_weights.resize(graph.num_edges);
+
+    vector<int64_t> row_ptr(N + 1);
+    file.seekg(layout.row_ptr_off);
+    file.read((char*)row_ptr.data(), row_ptr.size() * sizeof(int64_t));
+    for (int i = 0; i <= N; ++i) graph.row_ptr[i] = row_ptr[i];
+    file.seekg(layout.col_off);
+    file.read((char*)graph.col_indices.data(), graph.col_indices.size() * sizeof(int32_t));
+    file.seekg(layout.weight_off);
+    file.read((char*)graph.edge_weights.data(), graph.edge_weights.size() * sizeof(double));
+    file.seekg(layout.out_sum_off);
+    file.read((char*)graph.out_weight_sum.data(), graph.out_weight_sum.size() * sizeof(double));
+    return file.good();
+}
+
+// Builds the reverse (pull) graph: row v lists the in-neighbors u of v,
+// with edge_weights holding the transition probability w(u,v)/out(u).
+// out_weight_sum of the result keeps the *forward* out-weight of each node
+// so callers can still tell which nodes are dead ends.
+CSRGraph buildTransposeGraph(const CSRGraph& graph) {
+    int N = graph.num_nodes;
+    CSRGraph rev(N);
+    rev.num_edges = graph.num_edges;
+    rev.col_indices.resize(graph.num_edges);
+    rev.edge_weights.resize(graph.num_edges);
+
+    for (int k = 0; k < graph.num_edges; ++k) rev.row_ptr[graph.col_indices[k] + 1]++;
+    for (int i = 0; i < N; ++i) rev.row_ptr[i + 1] += rev.row_ptr[i];
+
+    vector<int> cursor(rev.row_ptr.begin(), rev.row_ptr.end() - 1);
+    for (int u = 0; u < N; ++u) {
+        for (int k = graph.row_ptr[u]; k < graph.row_ptr[u+1]; ++k) {
+            int pos = cursor[graph.col_indices[k]]++;
+            rev.col_indices[pos] = u;
+            // Rows whose edges all carry zero weight (masked future edges) are dead ends
+            rev.edge_weights[pos] = graph.out_weight_sum[u] > 0 ? graph.edge_weights[k] / graph.out_weight_sum[u] : 0.0;
+        }
+    }
+    rev.out_weight_sum = graph.out_weight_sum;
+    return rev;
+}
+
+// Re-derives edge_weights and out_weight_sum of a temporal graph for
+// 'query_time': w = base * 2^(-(t_ref - t) / half_life), and edges after
+// the query time get weight 0. Only ratios within a row matter to the
+// solvers, so t_ref is each row's newest active edge rather than the
+// query time itself; old rows then cannot underflow into dead ends.
+// half_life <= 0 only masks future edges. Returns the active edge count.
+long long applyTimeDecay(CSRGraph& graph, int64_t query_time, double half_life) {
+    ScopedTimer timer("temporal.decay");
+    double lambda = half_life > 0 ? log(2.0) / half_life : 0.0;
+    long long active = 0;
+    for (int u = 0; u < graph.num_nodes; ++u) {
+        int begin = graph.row_ptr[u], end = graph.row_ptr[u + 1];
+        int64_t t_ref = INT64_MIN;
+        for (int k = begin; k < end; ++k)
+            if (graph.edge_times[k] <= query_time) t_ref = max(t_ref, graph.edge_times[k]);
+
+        double sum_w = 0.0;
+        for (int k = begin; k < end; ++k) {
+            double w = 0.0;
+            if (graph.edge_times[k] <= query_time) {
+                w = graph.base_weights[k] * exp(-lambda * (double)(t_ref - graph.edge_times[k]));
+                active++;
+            }
+            graph.edge_weights[k] = w;
+            sum_w += w;
+        }
+        graph.out_weight_sum[u] = sum_w;
+    }
+    return active;
+}
+
+// =========================================================
+// SECTION 2: Algorithms
+// =========================================================
+
+// Stopping rule shared by all iterative PPR solvers
+struct ConvergencePolicy {
+    enum Criterion { L1, LINF, TOP_K_STABLE };
+
+    int max_iterations = 100;      // Hard cap on iterations (mat-vecs for BiCGSTAB)
+    Criterion criterion = L1;      // Which quantity must drop below 'tolerance'
+    double tolerance = 1e-6;       // Threshold for L1 / L-infinity criteria
+    int top_k = 100;               // Size of the ranking checked by TOP_K_STABLE
+    int stable_rounds = 3;         // Consecutive unchanged top-k sets required
+    long long time_budget_us = 0;  // Wall-clock budget (0 = unlimited)
+    bool record_trace = false;     // Keep a per-iteration trace in the result
+
+    ConvergencePolicy() = default;
+    explicit ConvergencePolicy(double tol) : tolerance(tol) {}
+};
+
+// One row of the optional per-iteration trace
+struct IterationTrace {
+    int iteration;
+    double residual_l1;
+    double residual_linf;
+    long long elapsed_us;
+    long long bytes_touched;   // Estimated memory traffic of this iteration
+    HwCounts hw = {};          // Hardware counters of this iteration (--hw-counters)
+};
+
+// Sparse score vector: (node id, score) pairs sorted by node id
+using SparseScores = vector<pair<int, double>>;
+
+struct AlgorithmResult {
+    vector<double> scores;     // Final suspicion scores (empty for sparse results)
+    long long duration_us = 0; // Execution time
+    long long iterations = 0;  // Iteration count / walks
+    bool converged = true;     // False when a cap or budget stopped the run
+    string stop_reason = "converged";
+    vector<IterationTrace> trace;
+    SparseScores sparse_scores; // Non-zero scores of local (sparse) engines
+    bool is_sparse = false;
+    HwCounts hw;               // Hardware counters of the whole call (--hw-counters)
+
+    AlgorithmResult() = default;
+    AlgorithmResult(vector<double> s, long long us, long long iters)
+        : scores(move(s)), duration_us(us), iterations(iters) {}
+
+    // Score of a single node regardless of representation
+    double scoreOf(int id) const {
+        if (!is_sparse) return (id >= 0 && id < (int)scores.size()) ? scores[id] : 0.0;
+        auto it = lower_bound(sparse_scores.begin(), sparse_scores.end(), make_pair(id, -(double)INFINITY));
+        return (it != sparse_scores.end() && it->first == id) ? it->second : 0.0;
+    }
+};
+
+// Thresholding step: keeps only entries strictly above 'threshold'
+SparseScores sparsify(const vector<double>& scores, double threshold = 0.0) {
+    SparseScores out;
+    for (size_t i = 0; i < scores.size(); ++i)
+        if (scores[i] > threshold) out.push_back({(int)i, scores[i]});
+    return out;
+}
+
+// Turns a dense result into a sparse one in place (local engines are sparse already)
+void makeSparse(AlgorithmResult& result, double threshold = 0.0) {
+    if (result.is_sparse) return;
+    result.sparse_scores = sparsify(result.scores, threshold);
+    vector<double>().swap(result.scores);
+    result.is_sparse = true;
+}
+
+// Applies a ConvergencePolicy iteration by iteration and records the trace
+class ConvergenceMonitor {
+    const ConvergencePolicy& policy;
+    high_resolution_clock::time_point start;
+    vector<int> prev_top;
+    int stable_count = 0;
+    long long last_elapsed = 0;
+    HwCounterGroup hw_group;
+    HwCounts hw_last;
+
+    // Sorted ids of the k highest scores
+    vector<int> topK(const vector<double>& scores) const {
+        int N = scores.size();
+        int k = min(policy.top_k, N);
+        vector<int> ids(N);
+        for (int i = 0; i < N; ++i) ids[i] = i;
+        nth_element(ids.begin(), ids.begin() + k, ids.end(),
+                    [&](int a, int b) { return scores[a] > scores[b]; });
+        ids.resize(k);
+        sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+public:
+    int iterations = 0;
+    bool converged = false;
+    string stop_reason = "max_iterations";
+    vector<IterationTrace> trace;
+
+    ConvergenceMonitor(const ConvergencePolicy& p, high_resolution_clock::time_point t0)
+        : policy(p), start(t0) { hw_last = hw_group.read(); }
+
+    // L-infinity costs an extra pass in power iteration, so only when used
+    bool needsLInf() const {
+        return policy.criterion == ConvergencePolicy::LINF || policy.record_trace;
+    }
+    bool canContinue() const { return iterations < policy.max_iterations; }
+
+    // Records one finished iteration; returns true when the solver should stop
+    bool update(double l1, double linf, const vector<double>& scores, long long bytes) {
+        iterations++;
+        long long elapsed = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+        Profiler& prof = Profiler::instance();
+        if (prof.enabled) {
+            prof.recordSpan("ppr.iteration", prof.nowUs() - (elapsed - last_elapsed), elapsed - last_elapsed);
+            prof.addCounter("ppr.bytes_touched", bytes);
+        }
+        last_elapsed = elapsed;
+        HwCounts hw_delta;
+        if (hw_group.active()) {
+            HwCounts now = hw_group.read();
+            hw_delta = now - hw_last;
+            hw_last = now;
+        }
+        if (policy.record_trace)
+            trace.push_back({iterations, l1, linf, elapsed, bytes, hw_delta});
+
+        switch (policy.criterion) {
+            case ConvergencePolicy::L1:   converged = l1 < policy.tolerance; break;
+            case ConvergencePolicy::LINF: converged = linf < policy.tolerance; break;
+            case ConvergencePolicy::TOP_K_STABLE: {
+                vector<int> top = topK(scores);
+                stable_count = (top == prev_top) ? stable_count + 1 : 0;
+                prev_top.swap(top);
+                converged = stable_count >= policy.stable_rounds;
+                break;
+            }
+        }
+        if (converged) { stop_reason = "converged"; return true; }
+        if (policy.time_budget_us > 0 && elapsed >= policy.time_budget_us) {
+            stop_reason = "time_budget";
+            return true;
+        }
+        return !canContinue();
+    }
+
+    AlgorithmResult finish(vector<double>&& scores) {
+        Profiler::instance().addCounter("ppr.iterations", iterations);
+        long long elapsed = duration_cast<microseconds>(high_resolution_clock::now() - start).count();
+        AlgorithmResult result(move(scores), elapsed, iterations);
+        result.converged = converged;
+        result.stop_reason = stop_reason;
+        result.trace = move(trace);
+        if (hw_group.active()) {
+            result.hw = hw_group.read();
+            HwCounterGroup::report("ppr", result.hw);
+        }
+        return result;
+    }
+};
+
+// Estimated bytes moved by one push/pull sweep over the CSR arrays
+// (row_ptr, col_indices, edge_weights, out_weight_sum, one scattered
+// read-modify-write per edge and the dense score vectors).
+static long long estimateSweepBytes(long long N, long long E) {
+    return (N + 1) * 4 + E * (4 + 8 + 16) + N * 8 * 4;
+}
+static long long estimateSweepBytes(const CSRGraph& graph) {
+    return estimateSweepBytes(graph.num_nodes, graph.num_edges);
+}
+
+// ---------- Fused Teleport / Convergence Kernels ----------
+
+// Computes r_new[i] = scale * r_new[i] and returns sum |r_new[i] - r[i]|.
+// The sparse seed contribution is added afterwards by the caller, so the
+// dense pass only touches two streams and can be fully vectorized.
+static double scaleAndDiffScalar(double* r_new, const double* r,
+                                 size_t n, double scale) {
+    double diff = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double val = scale * r_new[i];
+        diff += fabs(val - r[i]);
+        r_new[i] = val;
+    }
+    return diff;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("avx2")))
+static double scaleAndDiffAVX2(double* r_new, const double* r,
+                               size_t n, double scale) {
+    const __m256d vscale = _mm256_set1_pd(scale);
+    const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256d v0 = _mm256_mul_pd(vscale, _mm256_loadu_pd(r_new + i));
+        __m256d v1 = _mm256_mul_pd(vscale, _mm256_loadu_pd(r_new + i + 4));
+        acc0 = _mm256_add_pd(acc0, _mm256_and_pd(abs_mask, _mm256_sub_pd(v0, _mm256_loadu_pd(r + i))));
+        acc1 = _mm256_add_pd(acc1, _mm256_and_pd(abs_mask, _mm256_sub_pd(v1, _mm256_loadu_pd(r + i + 4))));
+        _mm256_storeu_pd(r_new + i, v0);
+        _mm256_storeu_pd(r_new + i + 4, v1);
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, _mm256_add_pd(acc0, acc1));
+    double diff = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    return diff + scaleAndDiffScalar(r_new + i, r + i, n - i, scale);
+}
+
+__attribute__((target("avx512f")))
+static double scaleAndDiffAVX512(double* r_new, const double* r,
+                                 size_t n, double scale) {
+    const __m512d vscale = _mm512_set1_pd(scale);
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512d v0 = _mm512_mul_pd(vscale, _mm512_loadu_pd(r_new + i));
+        __m512d v1 = _mm512_mul_pd(vscale, _mm512_loadu_pd(r_new + i + 8));
+        acc0 = _mm512_add_pd(acc0, _mm512_abs_pd(_mm512_sub_pd(v0, _mm512_loadu_pd(r + i))));
+        acc1 = _mm512_add_pd(acc1, _mm512_abs_pd(_mm512_sub_pd(v1, _mm512_loadu_pd(r + i + 8))));
+        _mm512_storeu_pd(r_new + i, v0);
+        _mm512_storeu_pd(r_new + i + 8, v1);
+    }
+    alignas(64) double lanes[8];
+    _mm512_store_pd(lanes, _mm512_add_pd(acc0, acc1));
+    double diff = 0.0;
+    for (double l : lanes) diff += l;
+    return diff + scaleAndDiffScalar(r_new + i, r + i, n - i, scale);
+}
+#endif
+
+// Runtime dispatch: picks the widest instruction set supported by the CPU
+static double scaleAndDiff(double* r_new, const double* r, size_t n, double scale) {
+#if defined(__x86_64__) || defined(__i386__)
+    static const auto kernel = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return &scaleAndDiffAVX512;
+        if (__builtin_cpu_supports("avx2")) return &scaleAndDiffAVX2;
+        return &scaleAndDiffScalar;
+    }();
+    return kernel(r_new, r, n, scale);
+#else
+    return scaleAndDiffScalar(r_new, r, n, scale);
+#endif
+}
+
+// ---------- Personalized PageRank (Exact / Power Iteration) ----------
+
+class PPREngine {
+    // Sparse personalization: each distinct seed receives 1/|seeds| mass
+    static vector<pair<int, double>> buildPersonalization(const vector<int>& seeds, int N) {
+        vector<pair<int, double>> p;
+        if (seeds.empty()) return p;
+        double mass = 1.0 / seeds.size();
+        vector<int> unique_seeds(seeds);
+        sort(unique_seeds.begin(), unique_seeds.end());
+        unique_seeds.erase(unique(unique_seeds.begin(), unique_seeds.end()), unique_seeds.end());
+        for (int id : unique_seeds) if (id >= 0 && id < N) p.push_back({id, mass});
+        return p;
+    }
+
+    // Starting vector: the warm start rescaled to unit mass, or p itself
+    // when no (usable) warm start is given
+    static vector<double> initialScores(const vector<pair<int, double>>& p, int N,
+                                        const vector<double>* warm_start) {
+        vector<double> r(N, 0.0);
+        double total = 0.0;
+        if (warm_start) {
+            for (int i = 0; i < N && i < (int)warm_start->size(); ++i) {
+                r[i] = fabs((*warm_start)[i]);
+                total += r[i];
+            }
+        }
+        if (total > 0.0) {
+            for (double& x : r) x /= total;
+        } else {
+            fill(r.begin(), r.end(), 0.0);
+            for (auto& s : p) r[s.first] = s.second;
+        }
+        return r;
+    }
+
+    // Gauss-Seidel sweep over nodes [begin, end) of the pull graph.
+    // Returns the L1 change and folds the largest single change into linf.
+    // In-block neighbors are read from r (freshest values), out-of-block
+    // neighbors from 'frozen' (pass r itself for a fully sequential sweep).
+    static double gaussSeidelSweep(const CSRGraph& rev, vector<double>& r,
+                                   const vector<double>& frozen,
+                                   const vector<double>& p_dense,
+                                   double alpha, double& dead_mass,
+                                   double& linf, int begin, int end) {
+        double diff = 0.0;
+        for (int v = begin; v < end; ++v) {
+            double sum = 0.0, self = 0.0;
+            for (int k = rev.row_ptr[v]; k < rev.row_ptr[v+1]; ++k) {
+                int u = rev.col_indices[k];
+                if (u == v) { self += rev.edge_weights[k]; continue; }
+                double ru = (u >= begin && u < end) ? r[u] : frozen[u];
+                sum += ru * rev.edge_weights[k];
+            }
+            // Solve the diagonal (self-loop) term exactly
+            double val = ((1.0 - alpha) * sum + (alpha + (1.0 - alpha) * dead_mass) * p_dense[v])
+                       / (1.0 - (1.0 - alpha) * self);
+            double old_val = r[v];
+            if (rev.out_weight_sum[v] == 0) dead_mass += val - old_val;
+            diff += fabs(val - old_val);
+            linf = max(linf, fabs(val - old_val));
+            r[v] = val;
+        }
+        return diff;
+    }
+
+public:
+    // CSR mat-vec kernel: r_new = P^T r (push along out-edges).
+    // Returns the mass sitting on dead-end nodes, which P^T drops.
+    static double propagate(const CSRGraph& graph, const vector<double>& r,
+                            vector<double>& r_new) {
+        int N = graph.num_nodes;
+        fill(r_new.begin(), r_new.end(), 0.0);
+        double dead_mass = 0.0;
+
+        // Push scores to outgoing neighbors
+        for (int u = 0; u < N; ++u) {
+            if (graph.out_weight_sum[u] > 0) {
+                for (int k = graph.row_ptr[u]; k < graph.row_ptr[u+1]; ++k) {
+                    int v = graph.col_indices[k];
+                    double w = graph.edge_weights[k];
+                    r_new[v] += r[u] * (w / graph.out_weight_sum[u]);
+                }
+            } else {
+                // Handle dead-end nodes
+                dead_mass += r[u];
+            }
+        }
+        return dead_mass;
+    }
+
+    static AlgorithmResult compute(const CSRGraph& graph,
+                                   const vector<int>& seeds,
+                                   double alpha,
+                                   double epsilon) {
+        return compute(graph, seeds, alpha, ConvergencePolicy(epsilon));
+    }
+
+    // warm_start (optional) is a previous score vector indexed by the
+    // current node IDs; iteration starts from it instead of from p.
+    static AlgorithmResult compute(const CSRGraph& graph,
+                                   const vector<int>& seeds,
+                                   double alpha,
+                                   const ConvergencePolicy& policy,
+                                   const vector<double>* warm_start = nullptr) {
+        ScopedTimer timer("ppr.power");
+        return powerIteration(graph.num_nodes, seeds, alpha, policy, warm_start,
+                              estimateSweepBytes(graph),
+                              [&](const vector<double>& r, vector<double>& r_new) {
+                                  return propagate(graph, r, r_new);
+                              });
+    }
+
+    // Power iteration over any mat-vec: propagate_fn(r, r_new) must set
+    // r_new = P^T r and return the dead-end mass, like propagate(), or a
+    // negative value when it failed (stop_reason "io_error", scores of the
+    // last complete iteration).
+    template <typename Propagate>
+    static AlgorithmResult powerIteration(int N,
+                                          const vector<int>& seeds,
+                                          double alpha,
+                                          const ConvergencePolicy& policy,
+                                          const vector<double>* warm_start,
+                                          long long sweep_bytes,
+                                          Propagate propagate_fn) {
+        ConvergenceMonitor monitor(policy, high_resolution_clock::now());
+
+        // Sparse personalization vector (probability mass on seed nodes)
+        vector<pair<int, double>> p = buildPersonalization(seeds, N);
+
+        vector<double> r = initialScores(p, N, warm_start), r_new(N);
+
+        // Power Iteration loop
+        while (monitor.canContinue()) {
+            double dead_mass = propagate_fn(r, r_new);
+            if (dead_mass < 0) {
+                monitor.stop_reason = "io_error";
+                break;
+            }
+
+            // Teleportation and convergence check (fused, vectorized dense pass)
+            double diff = scaleAndDiff(r_new.data(), r.data(), N, 1.0 - alpha);
+
+            // Seed correction: add teleport + dead-end mass on the sparse seed list
+            double teleport = alpha + (1.0 - alpha) * dead_mass;
+            for (auto& s : p) {
+                int i = s.first;
+                double old_val = r_new[i];
+                double val = old_val + teleport * s.second;
+                diff += fabs(val - r[i]) - fabs(old_val - r[i]);
+                r_new[i] = val;
+            }
+
+            r.swap(r_new);
+            double linf = 0.0;
+            if (monitor.needsLInf())
+                for (int i = 0; i < N; ++i) linf = max(linf, fabs(r[i] - r_new[i]));
+            if (monitor.update(diff, linf, r, sweep_bytes)) break;
+        }
+
+        return monitor.finish(move(r));
+    }
+
+    // Solves the PPR linear system  (I - (1-alpha)(P^T + p d^T)) r = alpha p
+    // with BiCGSTAB, where d marks dead-end nodes. Each operator application
+    // reuses the propagate() mat-vec kernel; the returned iteration count is
+    // the number of mat-vecs, so it is directly comparable to power iteration.
+    // The L1 / L-infinity criteria are applied to the linear-system residual,
+    // which equals the step size of power iteration from the same iterate.
+    static AlgorithmResult computeBiCGSTAB(const CSRGraph& graph,
+                                           const vector<int>& seeds,
+                                           double alpha,
+                                           double epsilon) {
+        return computeBiCGSTAB(graph, seeds, alpha, ConvergencePolicy(epsilon));
+    }
+
+    static AlgorithmResult computeBiCGSTAB(const CSRGraph& graph,
+                                           const vector<int>& seeds,
+                                           double alpha,
+                                           const ConvergencePolicy& policy,
+                                           const vector<double>* warm_start = nullptr) {
+        ScopedTimer timer("ppr.bicgstab");
+        ConvergenceMonitor monitor(policy, high_resolution_clock::now());
+        int N = graph.num_nodes;
+        long long sweep_bytes = estimateSweepBytes(graph);
+
+        vector<pair<int, double>> p = buildPersonalization(seeds, N);
+        vector<double> scratch(N);
+
+        // y = A x
+        auto apply = [&](const vector<double>& x, vector<double>& y) {
+            double dead_mass = propagate(graph, x, scratch);
+            for (int i = 0; i < N; ++i) y[i] = x[i] - (1.0 - alpha) * scratch[i];
+            for (auto& s : p) y[s.first] -= (1.0 - alpha) * dead_mass * s.second;
+        };
+        auto dot = [N](const vector<double>& a, const vector<double>& b) {
+            double acc = 0.0;
+            for (int i = 0; i < N; ++i) acc += a[i] * b[i];
+            return acc;
+        };
+        auto norm1 = [N](const vector<double>& a) {
+            double acc = 0.0;
+            for (int i = 0; i < N; ++i) acc += fabs(a[i]);
+            return acc;
+        };
+        auto normInf = [N](const vector<double>& a) {
+            double acc = 0.0;
+            for (int i = 0; i < N; ++i) acc = max(acc, fabs(a[i]));
+            return acc;
+        };
+
+        // Initial guess x = p (or the warm start), residual res = alpha p - A x
+        vector<double> x = initialScores(p, N, warm_start);
+        vector<double> res(N), rhat, dir(N, 0.0), v(N, 0.0), s(N), t(N);
+        apply(x, res);
+        for (int i = 0; i < N; ++i) res[i] = -res[i];
+        for (auto& e : p) res[e.first] += alpha * e.second;
+        rhat = res;
+
+        // Each half step costs one mat-vec and counts as one iteration.
+        // The initial residual's mat-vec is not counted, matching power
+        // iteration where r = p is free.
+        double rho = 1.0, step = 1.0, omega = 1.0;
+        while (monitor.canContinue()) {
+            double rho_new = dot(rhat, res);
+            if (rho_new == 0.0 || omega == 0.0) {
+                // Breakdown: restart the Krylov space from the current residual
+                rhat = res;
+                rho_new = dot(rhat, res);
+                if (rho_new == 0.0) {
+                    // Zero residual: x already solves the system
+                    monitor.converged = true;
+                    monitor.stop_reason = "converged";
+                    break;
+                }
+                fill(dir.begin(), dir.end(), 0.0);
+                fill(v.begin(), v.end(), 0.0);
+                rho = step = omega = 1.0;
+            }
+            double beta = (rho_new / rho) * (step / omega);
+            for (int i = 0; i < N; ++i) dir[i] = res[i] + beta * (dir[i] - omega * v[i]);
+
+            apply(dir, v);
+            double rhat_v = dot(rhat, v);
+            if (!isfinite(rhat_v) || fabs(rhat_v) <= 1e-15 * sqrt(dot(rhat, rhat) * dot(v, v))) {
+                // rhat is (numerically) orthogonal to A dir: the step is undefined
+                monitor.stop_reason = "breakdown";
+                break;
+            }
+            step = rho_new / rhat_v;
+            for (int i = 0; i < N; ++i) s[i] = res[i] - step * v[i];
+
+            // Half step: x + step*dir is an iterate with residual s
+            for (int i = 0; i < N; ++i) x[i] += step * dir[i];
+            if (monitor.update(norm1(s), normInf(s), x, sweep_bytes)) break;
+
+            apply(s, t);
+            double tt = dot(t, t);
+            omega = (tt > 0.0) ? dot(t, s) / tt : 0.0;
+            for (int i = 0; i < N; ++i) {
+                x[i] += omega * s[i];
+                res[i] = s[i] - omega * t[i];
+            }
+            rho = rho_new;
+            if (monitor.update(norm1(res), normInf(res), x, sweep_bytes)) break;
+        }
+
+        return monitor.finish(move(x));
+    }
+
+    // In-place Gauss-Seidel iteration on the pull formulation.
+    // Each sweep uses the freshest available scores, which typically needs
+    // far fewer passes over the graph than the Jacobi-style power iteration.
+    // With num_threads > 1 the nodes are split into contiguous blocks that
+    // are swept concurrently (Gauss-Seidel inside a block, Jacobi between
+    // blocks using a snapshot taken at the start of each sweep).
+    static AlgorithmResult computeGaussSeidel(const CSRGraph& graph,
+                                              const vector<int>& seeds,
+                                              double alpha,
+                                              double epsilon,
+                                              int num_threads = 1) {
+        return computeGaussSeidel(graph, seeds, alpha, ConvergencePolicy(epsilon), num_threads);
+    }
+
+    static AlgorithmResult computeGaussSeidel(const CSRGraph& graph,
+                                              const vector<int>& seeds,
+                                              double alpha,
+                                              const ConvergencePolicy& policy,
+                                              int num_threads = 1,
+                                              const vector<double>* warm_start = nullptr) {
+        ScopedTimer timer("ppr.gauss_seidel");
+        ConvergenceMonitor monitor(policy, high_resolution_clock::now());
+        int N = graph.num_nodes;
+
+        CSRGraph rev = buildTransposeGraph(graph);
+        long long sweep_bytes = estimateSweepBytes(rev);
+        vector<pair<int, double>> p = buildPersonalization(seeds, N);
+        vector<double> p_dense(N, 0.0), r = initialScores(p, N, warm_start);
+        for (auto& s : p) p_dense[s.first] = s.second;
+
+        double dead_mass = 0.0;
+        for (int u = 0; u < N; ++u)
+            if (graph.out_weight_sum[u] == 0) dead_mass += r[u];
+
+        // Partition nodes into blocks of roughly equal in-edge count
+        num_threads = max(1, min(num_threads, N));
+        vector<int> bounds = {0};
+        for (int t = 1; t < num_threads; ++t) {
+            long long target = (long long)graph.num_edges * t / num_threads;
+            int b = upper_bound(rev.row_ptr.begin(), rev.row_ptr.end(), target) - rev.row_ptr.begin() - 1;
+            bounds.push_back(max(bounds.back(), min(b, N)));
+        }
+        bounds.push_back(N);
+
+        vector<double> frozen;
+
+        while (monitor.canContinue()) {
+            double diff = 0.0, linf = 0.0;
+
+            if (num_threads == 1) {
+                diff = gaussSeidelSweep(rev, r, r, p_dense, alpha, dead_mass, linf, 0, N);
+            } else {
+                frozen = r;
+                vector<double> block_diff(num_threads, 0.0), block_linf(num_threads, 0.0);
+                vector<double> block_dead(num_threads, dead_mass);
+                vector<thread> workers;
+                for (int t = 0; t < num_threads; ++t)
+                    workers.emplace_back([&, t] {
+                        block_diff[t] = gaussSeidelSweep(rev, r, frozen, p_dense, alpha, block_dead[t],
+                                                         block_linf[t], bounds[t], bounds[t+1]);
+                    });
+                for (auto& w : workers) w.join();
+                for (int t = 0; t < num_threads; ++t) {
+                    diff += block_diff[t];
+                    linf = max(linf, block_linf[t]);
+                }
+
+                // Blocks only saw their own dead-end updates; recompute exactly
+                dead_mass = 0.0;
+                for (int u = 0; u < N; ++u)
+                    if (graph.out_weight_sum[u] == 0) dead_mass += r[u];
+            }
+
+            if (monitor.update(diff, linf, r, sweep_bytes)) break;
+        }
+
+        return monitor.finish(move(r));
+    }
+};
+
+
+// ---------- Semi-External PPR (Streamed CSR Snapshot) ----------
+
+// Edge arrays of a CSR snapshot streamed from disk. Only the O(N) parts
+// (row_ptr, out_weight_sum) are resident; each sweep reads col_indices
+// and edge_weights sequentially in blocks through pread. One reader
+// thread lives as long as the stream and fills one buffer while the
+// caller consumes the other. Readahead hints (POSIX_FADV_SEQUENTIAL,
+// WILLNEED on the next block) keep the disk busy.
+class SnapshotEdgeStream {
+    struct Buffer {
+        vector<int32_t> cols;
+        vector<double> weights;
+        uint64_t first = 0;
+        size_t count = 0;
+        bool ready = false;
+    };
+
+    int fd = -1;
+    uint64_t num_nodes = 0, num_edges = 0;
+    uint64_t col_off = 0, weight_off = 0;
+    size_t block_edges = 1 << 20;
+
+    // Reader state: sweeps_requested runs ahead of sweeps_started by at
+    // most one; a read error is sticky
+    Buffer bufs[2];
+    thread reader;
+    mutex m;
+    condition_variable cv;
+    uint64_t sweeps_requested = 0, sweeps_started = 0;
+    bool stopping = false;
+    bool failed = false;
+
+    void readerLoop() {
+        uint64_t num_blocks = (num_edges + block_edges - 1) / block_edges;
+        while (true) {
+            {
+                unique_lock<mutex> lock(m);
+                cv.wait(lock, [&] { return stopping || sweeps_started < sweeps_requested; });
+                if (stopping) return;
+                sweeps_started++;
+            }
+            for (uint64_t b = 0; b < num_blocks; ++b) {
+                Buffer& buf = bufs[b & 1];
+                {
+                    unique_lock<mutex> lock(m);
+                    cv.wait(lock, [&] { return stopping || !buf.ready; });
+                    if (stopping) return;
+                }
+                buf.first = b * block_edges;
+                buf.count = min<uint64_t>(block_edges, num_edges - buf.first);
+                bool ok = preadFull(fd, buf.cols.data(), buf.count * sizeof(int32_t),
+                                    col_off + buf.first * sizeof(int32_t)) &&
+                          preadFull(fd, buf.weights.data(), buf.count * sizeof(double),
+                                    weight_off + buf.first * sizeof(double));
+                uint64_t next = buf.first + buf.count;
+                posix_fadvise(fd, col_off + next * sizeof(int32_t), block_edges * sizeof(int32_t), POSIX_FADV_WILLNEED);
+                posix_fadvise(fd, weight_off + next * sizeof(double), block_edges * sizeof(double), POSIX_FADV_WILLNEED);
+                {
+                    lock_guard<mutex> lock(m);
+                    buf.ready = ok;
+                    failed = failed || !ok;
+                }
+                cv.notify_all();
+                if (!ok) break;
+            }
+        }
+    }
+
+public:
+    vector<int64_t> row_ptr;
+    vector<double> out_weight_sum;
+
+    SnapshotEdgeStream() = default;
+    SnapshotEdgeStream(const SnapshotEdgeStream&) = delete;
+    SnapshotEdgeStream& operator=(const SnapshotEdgeStream&) = delete;
+    ~SnapshotEdgeStream() {
+        if (reader.joinable()) {
+            {
+                lock_guard<mutex> lock(m);
+                stopping = true;
+            }
+            cv.notify_all();
+            reader.join();
+        }
+        if (fd >= 0) close(fd);
+    }
+
+    // Opens a snapshot built with 'policy'; block_bytes is the size of each
+    // of the two buffers
+    bool open(const string& snapshot_file, size_t block_bytes, const EdgePolicy& policy = EdgePolicy()) {
+        fd = ::open(snapshot_file.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        CSRSnapshotHeader hdr;
+        if (!preadFull(fd, &hdr, sizeof(hdr), 0) || memcmp(hdr.magic, "PPRCSR2", 8) != 0) return false;
+        if (!snapshotPolicyMatches(hdr, policy)) return false;
+        // Node ids are int: larger (or corrupt) headers must not truncate
+        if (hdr.num_nodes >= (uint64_t)INT32_MAX) return false;
+        CSRSnapshotLayout layout(hdr.num_nodes, hdr.num_edges);
+        num_nodes = hdr.num_nodes;
+        num_edges = hdr.num_edges;
+        col_off = layout.col_off;
+        weight_off = layout.weight_off;
+        block_edges = max<size_t>(block_bytes / (sizeof(int32_t) + sizeof(double)), 4096);
+
+        row_ptr.resize(num_nodes + 1);
+        out_weight_sum.resize(num_nodes);
+        if (!preadFull(fd, row_ptr.data(), row_ptr.size() * sizeof(int64_t), layout.row_ptr_off) ||
+            !preadFull(fd, out_weight_sum.data(), out_weight_sum.size() * sizeof(double), layout.out_sum_off))
+            return false;
+        posix_fadvise(fd, col_off, layout.out_sum_off - col_off, POSIX_FADV_SEQUENTIAL);
+
+        for (Buffer& b : bufs) {
+            b.cols.resize(block_edges);
+            b.weights.resize(block_edges);
+        }
+        reader = thread([this] { readerLoop(); });
+        return true;
+    }
+
+    int numNodes() const { return num_nodes; }
+    uint64_t numEdges() const { return num_edges; }
+
+    // Calls fn(first_edge, count, cols, weights) for consecutive edge blocks
+    // in CSR order; returns false on a read error (now or in an earlier sweep)
+    template <typename Fn>
+    bool forEachBlock(Fn fn) {
+        uint64_t num_blocks = (num_edges + block_edges - 1) / block_edges;
+        {
+            lock_guard<mutex> lock(m);
+            if (failed) return false;
+            sweeps_requested++;
+        }
+        cv.notify_all();
+
+        long long wait_us = 0;
+        bool ok = true;
+        for (uint64_t b = 0; b < num_blocks; ++b) {
+            Buffer& buf = bufs[b & 1];
+            {
+                auto t0 = high_resolution_clock::now();
+                unique_lock<mutex> lock(m);
+                cv.wait(lock, [&] { return buf.ready || failed; });
+                wait_us += duration_cast<microseconds>(high_resolution_clock::now() - t0).count();
+                if (!buf.ready) {
+                    ok = false;
+                    break;
+                }
+            }
+            fn(buf.first, buf.count, buf.cols.data(), buf.weights.data());
+            {
+                lock_guard<mutex> lock(m);
+                buf.ready = false;
+            }
+            cv.notify_all();
+        }
+
+        Profiler& prof = Profiler::instance();
+        prof.addCounter("sx.bytes_read", num_edges * (sizeof(int32_t) + sizeof(double)));
+        prof.addCounter("sx.io_wait_us", wait_us);
+        return ok;
+    }
+};
+
+// Power iteration whose mat-vec streams the edge arrays once per
+// iteration; scores match PPREngine::compute on the in-memory graph.
+// A read error stops the solve with stop_reason "io_error".
+class SemiExternalPPR {
+public:
+    static AlgorithmResult compute(SnapshotEdgeStream& stream,
+                                   const vector<int>& seeds,
+                                   double alpha,
+                                   const ConvergencePolicy& policy) {
+        ScopedTimer timer("ppr.semi_external");
+        int N = stream.numNodes();
+        long long sweep_bytes = estimateSweepBytes(N, stream.numEdges());
+        const vector<int64_t>& row_ptr = stream.row_ptr;
+        const vector<double>& out_weight_sum = stream.out_weight_sum;
+
+        return PPREngine::powerIteration(N, seeds, alpha, policy, nullptr, sweep_bytes,
+            [&](const vector<double>& r, vector<double>& r_new) {
+                fill(r_new.begin(), r_new.end(), 0.0);
+                double dead_mass = 0.0;
+                for (int u = 0; u < N; ++u)
+                    if (out_weight_sum[u] == 0) dead_mass += r[u];
+
+                int u = 0;
+                bool ok = stream.forEachBlock([&](uint64_t first, size_t count,
+                                                  const int32_t* cols, const double* weights) {
+                    for (size_t i = 0; i < count; ++i) {
+                        while ((uint64_t)row_ptr[u + 1] <= first + i) ++u;
+                        r_new[cols[i]] += r[u] * (weights[i] / out_weight_sum[u]);
+                    }
+                });
+                return ok ? dead_mass : -1.0;
+            });
+    }
+};
+
+// ---------- Absorbed Single-Seed PPR ----------
+
+// PPR is linear in the personalization vector once dead-end mass is
+// treated as absorbed: x = alpha (I - (1-alpha) P^T)^-1 p. The engine's
+// dangling-to-seed variant is exactly x / |x|_1, and for a single seed the
+// absorbed vector is recovered as x_s = r_s * alpha / (alpha + (1-alpha) D_s),
+// where D_s is the mass r_s leaves on dead ends. x_s / alpha is also the
+// expected visit count of a Monte Carlo walk started at s.
+// Returns the top max_entries non-zeros of x_s, sorted by node id.
+SparseScores computeAbsorbedPPR(const CSRGraph& graph, int seed, double alpha,
+                                const ConvergencePolicy& policy,
+                                size_t max_entries, int& iterations) {
+    AlgorithmResult res = PPREngine::compute(graph, {seed}, alpha, policy);
+    iterations += res.iterations;
+
+    double dead = 0.0;
+    for (int u = 0; u < graph.num_nodes; ++u)
+        if (graph.out_weight_sum[u] == 0) dead += res.scores[u];
+    double scale = alpha / (alpha + (1.0 - alpha) * dead);
+
+    SparseScores vec = sparsify(res.scores);
+    for (auto& e : vec) e.second *= scale;
+    if (vec.size() > max_entries) {
+        nth_element(vec.begin(), vec.begin() + max_entries, vec.end(),
+                    [](const pair<int, double>& a, const pair<int, double>& b) {
+                        return a.second > b.second;
+                    });
+        vec.resize(max_entries);
+    }
+    sort(vec.begin(), vec.end());
+    vec.shrink_to_fit();
+    return vec;
+}
+
+// ---------- Hub Index (HubPPR-Style Precomputation) ----------
+
+// Offline index of absorbed PPR vectors for the highest-degree nodes.
+// Random walks that reach a hub stop there and add the hub's expected
+// visit counts instead of scanning its (huge) adjacency list.
+//
+// On-disk layout (little-endian, every section 8-byte aligned so the
+// file can be used directly through mmap):
+//   char     magic[8]          "PPRHUB2"
+//   uint64   num_hubs, num_nodes
+//   double   alpha
+//   uint64   total_entries
+//   uint64   num_edges, fingerprint   graph the index was built for
+//   uint64   offsets[num_hubs + 1]   entry range per hub
+//   double   scores[total_entries]   absorbed PPR values
+//   int32    hub_ids[num_hubs]
+//   int32    entry_ids[total_entries]
+class HubIndex {
+    struct Header {
+        char magic[8];
+        uint64_t num_hubs;
+        uint64_t num_nodes;
+        double alpha;
+        uint64_t total_entries;
+        uint64_t num_edges;
+        uint64_t fingerprint;   // graphFingerprint() of the graph it was built for
+    };
+
+    void* mapping = MAP_FAILED;
+    size_t mapping_size = 0;
+    const Header* header = nullptr;
+    const uint64_t* offsets = nullptr;
+    const double* scores = nullptr;
+    const int32_t* hub_ids = nullptr;
+    const int32_t* entry_ids = nullptr;
+    vector<int> hub_slot;   // node id -> hub index, or -1
+
+public:
+    HubIndex() = default;
+    HubIndex(const HubIndex&) = delete;
+    HubIndex& operator=(const HubIndex&) = delete;
+    ~HubIndex() { unload(); }
+
+    void unload() {
+        if (mapping != MAP_FAILED) munmap(mapping, mapping_size);
+        mapping = MAP_FAILED;
+        header = nullptr;
+        hub_slot.clear();
+    }
+
+    // Hash of the structure and weights, so an index is never reused for
+    // another graph that happens to have the same node count
+    static uint64_t graphFingerprint(const CSRGraph& graph) {
+        uint64_t h = 1469598103934665603ULL ^ (uint64_t)graph.num_edges;
+        auto mix = [&h](uint64_t x) { h = (h ^ x) * 1099511628211ULL; h ^= h >> 29; };
+        for (int v : graph.row_ptr) mix((uint32_t)v);
+        for (int v : graph.col_indices) mix((uint32_t)v);
+        for (double w : graph.edge_weights) {
+            uint64_t bits;
+            memcpy(&bits, &w, sizeof(bits));
+            mix(bits);
+        }
+        return h;
+    }
+
+    // Selects the num_hubs nodes with the largest in+out degree, computes
+    // their truncated absorbed PPR vectors and writes the index file.
+    static bool build(const CSRGraph& graph, double alpha, int num_hubs,
+                      size_t max_entries, const string& filename) {
+        int N = graph.num_nodes;
+        vector<long long> degree(N, 0);
+        for (int u = 0; u < N; ++u) degree[u] += graph.row_ptr[u+1] - graph.row_ptr[u];
+        for (int k = 0; k < graph.num_edges; ++k) degree[graph.col_indices[k]]++;
+
+        vector<int> hubs(N);
+        for (int i = 0; i < N; ++i) hubs[i] = i;
+        num_hubs = max(0, min(num_hubs, N));
+        partial_sort(hubs.begin(), hubs.begin() + num_hubs, hubs.end(),
+                     [&](int a, int b) { return degree[a] > degree[b]; });
+        hubs.resize(num_hubs);
+        sort(hubs.begin(), hubs.end());
+
+        ConvergencePolicy policy(1e-9);
+        policy.max_iterations = 1000;
+        vector<uint64_t> offs = {0};
+        vector<double> vals;
+        vector<int32_t> ids;
+        int iterations = 0;
+        for (int h : hubs) {
+            for (auto& e : computeAbsorbedPPR(graph, h, alpha, policy, max_entries, iterations)) {
+                ids.push_back(e.first);
+                vals.push_back(e.second);
+            }
+            offs.push_back(ids.size());
+        }
+
+        ofstream file(filename, ios::binary);
+        if (!file.is_open()) return false;
+        Header hdr = {{'P', 'P', 'R', 'H', 'U', 'B', '2', 0},
+                      (uint64_t)num_hubs, (uint64_t)N, alpha, (uint64_t)ids.size(),
+                      (uint64_t)graph.num_edges, graphFingerprint(graph)};
+        vector<int32_t> hub32(hubs.begin(), hubs.end());
+        auto writeAligned = [&](const void* data, size_t bytes) {
+            file.write((const char*)data, bytes);
+            static const char pad[8] = {0};
+            if (bytes % 8) file.write(pad, 8 - bytes % 8);
+        };
+        writeAligned(&hdr, sizeof(hdr));
+        writeAligned(offs.data(), offs.size() * sizeof(uint64_t));
+        writeAligned(vals.data(), vals.size() * sizeof(double));
+        writeAligned(hub32.data(), hub32.size() * sizeof(int32_t));
+        writeAligned(ids.data(), ids.size() * sizeof(int32_t));
+        return file.good();
+    }
+
+    // Maps an index file; fails if it is malformed or built for another graph
+    bool load(const string& filename, const CSRGraph& graph) {
+        unload();
+        int num_nodes = graph.num_nodes;
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Header)) { close(fd); return false; }
+        mapping_size = st.st_size;
+        mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) return false;
+
+        auto align8 = [](size_t b) { return (b + 7) & ~(size_t)7; };
+        const char* base = (const char*)mapping;
+        header = (const Header*)base;
+        if (memcmp(header->magic, "PPRHUB2", 8) != 0 || header->num_nodes != (uint64_t)num_nodes ||
+            header->num_edges != (uint64_t)graph.num_edges || header->fingerprint != graphFingerprint(graph)) {
+            unload();
+            return false;
+        }
+        size_t H = header->num_hubs, T = header->total_entries;
+        size_t pos = align8(sizeof(Header));
+        offsets = (const uint64_t*)(base + pos);   pos += align8((H + 1) * sizeof(uint64_t));
+        scores = (const double*)(base + pos);      pos += align8(T * sizeof(double));
+        hub_ids = (const int32_t*)(base + pos);    pos += align8(H * sizeof(int32_t));
+        entry_ids = (const int32_t*)(base + pos);  pos += align8(T * sizeof(int32_t));
+        if (pos > mapping_size || H > (size_t)num_nodes || offsets[0] != 0 || offsets[H] != T) {
+            unload();
+            return false;
+        }
+        // Every id is used as an array index later, so check them all
+        for (size_t h = 0; h < H; ++h)
+            if (offsets[h] > offsets[h + 1] || hub_ids[h] < 0 || hub_ids[h] >= num_nodes) {
+                unload();
+                return false;
+            }
+        for (size_t k = 0; k < T; ++k)
+            if (entry_ids[k] < 0 || entry_ids[k] >= num_nodes) {
+                unload();
+                return false;
+            }
+
+        hub_slot.assign(num_nodes, -1);
+        for (size_t h = 0; h < H; ++h) hub_slot[hub_ids[h]] = h;
+        return true;
+    }
+
+    double alpha() const { return header ? header->alpha : -1.0; }
+    int numHubs() const { return header ? header->num_hubs : 0; }
+    int slotOf(int node) const { return hub_slot.empty() ? -1 : hub_slot[node]; }
+
+    // Calls fn(node, absorbed score) for every stored entry of hub 'slot'
+    template <typename Fn>
+    void forEachEntry(int slot, Fn fn) const {
+        for (uint64_t k = offsets[slot]; k < offsets[slot + 1]; ++k)
+            fn(entry_ids[k], scores[k]);
+    }
+};
+
+// ---------- Monte Carlo Approximation (Bonus Method) ----------
+
+class MonteCarloEngine {
+    // Simulates total_walks walks from uniformly chosen seeds and adds
+    // their visits to 'visits' (a dense vector or a hash map, both indexed
+    // by node). With a hub index built for the same alpha, walks that
+    // reach a hub stop there and add the hub's expected visit counts.
+    // Returns the number of walk steps taken.
+    template <typename Visits>
+    static long long runWalks(const CSRGraph& graph, const vector<int>& seeds, double alpha,
+                              long long total_walks, const HubIndex* hubs, Visits& visits) {
+        random_device rd;
+        mt19937 gen(rd());
+        uniform_real_distribution<> prob(0.0, 1.0);
+        uniform_int_distribution<> seed_dist(0, seeds.size() - 1);
+        double hub_scale = hubs ? 1.0 / hubs->alpha() : 0.0;
+        long long steps = 0;
+
+        for (long long i = 0; i < total_walks; ++i) {
+            int curr = seeds[seed_dist(gen)];
+
+            while (true) {
+                // Short-circuit: the rest of the walk is known in expectation
+                int slot = hubs ? hubs->slotOf(curr) : -1;
+                if (slot >= 0) {
+                    hubs->forEachEntry(slot, [&](int v, double x) { visits[v] += x * hub_scale; });
+                    break;
+                }
+
+                visits[curr] += 1.0;
+                steps++;
+
+                // Teleport / stop condition
+                if (prob(gen) < alpha) break;
+                if (graph.out_weight_sum[curr] == 0) break;
+
+                // Weighted neighbor selection
+                double target = prob(gen) * graph.out_weight_sum[curr];
+                double acc = 0.0;
+
+                for (int k = graph.row_ptr[curr]; k < graph.row_ptr[curr+1]; ++k) {
+                    acc += graph.edge_weights[k];
+                    if (target <= acc) {
+                        curr = graph.col_indices[k];
+                        break;
+                    }
+                }
+            }
+        }
+
+        Profiler::instance().addCounter("mc.walks", total_walks);
+        Profiler::instance().addCounter("mc.walk_steps", steps);
+        return steps;
+    }
+
+public:
+    static AlgorithmResult compute(const CSRGraph& graph,
+                                   const vector<int>& seeds,
+                                   double alpha,
+                                   long long total_walks,
+                                   const HubIndex* hubs = nullptr) {
+        ScopedTimer timer("mc.walks");
+        HwCounterGroup hw_group;
+        auto start = high_resolution_clock::now();
+        int N = graph.num_nodes;
+        vector<double> visits(N, 0.0);
+        if (hubs && fabs(hubs->alpha() - alpha) > 1e-12) hubs = nullptr;
+
+        if (seeds.empty()) return AlgorithmResult(vector<double>(N, 0.0), 0, 0);
+        runWalks(graph, seeds, alpha, total_walks, hubs, visits);
+
+        // Normalize visit counts to probabilities
+        vector<double> scores(N, 0.0);
+        double total = 0.0;
+        for (double v : visits) total += v;
+        if (total > 0)
+            for (int i = 0; i < N; ++i)
+                scores[i] = visits[i] / total;
+
+        auto end = high_resolution_clock::now();
+        AlgorithmResult result(scores, duration_cast<microseconds>(end - start).count(), total_walks);
+        result.hw = hw_group.read();
+        HwCounterGroup::report("mc", result.hw);
+        return result;
+    }
+
+    // Local variant: visit counts live in a hash map, so memory and output
+    // size scale with the nodes actually reached rather than with N.
+    static AlgorithmResult computeSparse(const CSRGraph& graph,
+                                         const vector<int>& seeds,
+                                         double alpha,
+                                         long long total_walks,
+                                         const HubIndex* hubs = nullptr) {
+        ScopedTimer timer("mc.walks_sparse");
+        HwCounterGroup hw_group;
+        auto start = high_resolution_clock::now();
+        unordered_map<int, double> visits;
+        if (hubs && fabs(hubs->alpha() - alpha) > 1e-12) hubs = nullptr;
+
+        AlgorithmResult result;
+        result.is_sparse = true;
+        if (seeds.empty()) return result;
+        runWalks(graph, seeds, alpha, total_walks, hubs, visits);
+
+        result.sparse_scores.assign(visits.begin(), visits.end());
+        sort(result.sparse_scores.begin(), result.sparse_scores.end());
+        double total = 0.0;
+        for (auto& e : result.sparse_scores) total += e.second;
+        if (total > 0)
+            for (auto& e : result.sparse_scores) e.second /= total;
+
+        auto end = high_resolution_clock::now();
+        result.duration_us = duration_cast<microseconds>(end - start).count();
+        result.iterations = total_walks;
+        result.hw = hw_group.read();
+        HwCounterGroup::report("mc", result.hw);
+        return result;
+    }
+};
+
+// ---------- Per-Seed PPR Cache (Linearity-Based Composition) ----------
+
+// A multi-seed query is a weighted sum of absorbed single-seed vectors
+// (see computeAbsorbedPPR), renormalized to unit mass.
+//
+// Entries are top-truncated sparse vectors kept under a byte budget with
+// LRU eviction. The cache is tied to one graph: call clear() if it changes.
+class PPRCache {
+    struct Entry {
+        SparseScores vec;
+        list<uint64_t>::iterator lru_pos;
+    };
+
+    size_t memory_budget;        // Bytes allowed for cached entries
+    size_t max_entries;          // Non-zeros kept per seed vector
+    ConvergencePolicy policy;    // Used for single-seed solves on a miss
+    unordered_map<uint64_t, Entry> entries;
+    list<uint64_t> lru;          // Most recently used at the front
+    size_t bytes_used = 0;
+
+    static uint64_t makeKey(int seed, double alpha) {
+        return ((uint64_t)llround(alpha * 1e6) << 32) | (uint32_t)seed;
+    }
+    static size_t entryBytes(const SparseScores& v) {
+        return v.size() * sizeof(pair<int, double>) + sizeof(Entry) + sizeof(uint64_t);
+    }
+
+    void evictToBudget() {
+        while (bytes_used > memory_budget && lru.size() > 1) {
+            auto it = entries.find(lru.back());
+            bytes_used -= entryBytes(it->second.vec);
+            entries.erase(it);
+            lru.pop_back();
+        }
+    }
+
+    // Solves single-seed PPR and stores its truncated absorbed vector
+    const SparseScores& computeSeed(const CSRGraph& graph, int seed, double alpha,
+                                 int& iterations) {
+        SparseScores vec = computeAbsorbedPPR(graph, seed, alpha, policy, max_entries, iterations);
+
+        uint64_t key = makeKey(seed, alpha);
+        lru.push_front(key);
+        bytes_used += entryBytes(vec);
+        Entry& e = entries[key];
+        e.vec = move(vec);
+        e.lru_pos = lru.begin();
+        evictToBudget();
+        return e.vec;
+    }
+
+public:
+    long long hits = 0, misses = 0;
+
+    PPRCache(size_t budget_bytes, size_t max_entries_per_seed,
+             const ConvergencePolicy& solve_policy = ConvergencePolicy())
+        : memory_budget(budget_bytes), max_entries(max_entries_per_seed),
+          policy(solve_policy) {}
+
+    size_t bytesUsed() const { return bytes_used; }
+    size_t size() const { return entries.size(); }
+
+    void clear() {
+        entries.clear();
+        lru.clear();
+        bytes_used = 0;
+    }
+
+    // Multi-seed PPR (uniform mass over distinct seeds) composed from cached
+    // single-seed vectors; only seeds not yet cached are solved. The result
+    // is sparse and the reported iteration count is the solver work spent
+    // on cache misses.
+    AlgorithmResult compose(const CSRGraph& graph, const vector<int>& seeds, double alpha) {
+        auto start = high_resolution_clock::now();
+        int N = graph.num_nodes;
+        unordered_map<int, double> acc;
+        int iterations = 0;
+
+        vector<int> unique_seeds(seeds);
+        sort(unique_seeds.begin(), unique_seeds.end());
+        unique_seeds.erase(unique(unique_seeds.begin(), unique_seeds.end()), unique_seeds.end());
+
+        for (int seed : unique_seeds) {
+            if (seed < 0 || seed >= N) continue;
+            auto it = entries.find(makeKey(seed, alpha));
+            const SparseScores* vec;
+            if (it != entries.end()) {
+                hits++;
+                lru.splice(lru.begin(), lru, it->second.lru_pos);
+                vec = &it->second.vec;
+            } else {
+                misses++;
+                vec = &computeSeed(graph, seed, alpha, iterations);
+            }
+            for (auto& e : *vec) acc[e.first] += e.second;
+        }
+
+        AlgorithmResult result({}, 0, iterations);
+        result.is_sparse = true;
+        result.sparse_scores.assign(acc.begin(), acc.end());
+        sort(result.sparse_scores.begin(), result.sparse_scores.end());
+
+        double total = 0.0;
+        for (auto& e : result.sparse_scores) total += e.second;
+        if (total > 0.0)
+            for (auto& e : result.sparse_scores) e.second /= total;
+
+        auto end = high_resolution_clock::now();
+        result.duration_us = duration_cast<microseconds>(end - start).count();
+        return result;
+    }
+};
+
+// =========================================================
+// Utility: Save Results to CSV
+// =========================================================
+
+// std::sort with up to num_threads threads: chunks are sorted concurrently,
+// then merged pairwise in parallel rounds. 'cmp' must be a strict weak
+// ordering; elements that compare equal may end up in any order.
+template <typename T, typename Cmp>
+void parallelSort(vector<T>& data, Cmp cmp, int num_threads) {
+    size_t n = data.size();
+    if (num_threads <= 1 || n < (1u << 16)) {
+        sort(data.begin(), data.end(), cmp);
+        return;
+    }
+    vector<size_t> bounds;
+    for (int t = 0; t <= num_threads; ++t) bounds.push_back(n * t / num_threads);
+
+    vector<thread> workers;
+    for (int t = 0; t < num_threads; ++t)
+        workers.emplace_back([&, t] { sort(data.begin() + bounds[t], data.begin() + bounds[t+1], cmp); });
+    for (auto& w : workers) w.join();
+
+    for (size_t width = 1; width < (size_t)num_threads; width *= 2) {
+        workers.clear();
+        for (size_t t = 0; t + width < (size_t)num_threads; t += 2 * width) {
+            size_t lo = bounds[t], mid = bounds[t + width];
+            size_t hi = bounds[min(t + 2 * width, (size_t)num_threads)];
+            workers.emplace_back([&, lo, mid, hi] {
+                inplace_merge(data.begin() + lo, data.begin() + mid, data.begin() + hi, cmp);
+            });
+        }
+        for (auto& w : workers) w.join();
+    }
+}
+
+// Writes ranked (score, id) rows; 'ranked' is reordered in place.
+// top_k > 0 keeps only the k best rows (partial sort instead of a full one);
+// a full sort uses up to sort_threads threads.
+static void writeRankedCSV(const string& filename,
+                           vector<pair<double, int>>& ranked,
+                           const NodeMapper& mapper,
+                           const vector<int>& seeds,
+                           size_t top_k = 0,
+                           int sort_threads = 1) {
+    ScopedTimer timer("output.csv");
+
+    // Sorted seed list: O(log S) membership, independent of N for sparse output
+    vector<int> sorted_seeds(seeds);
+    sort(sorted_seeds.begin(), sorted_seeds.end());
+
+    auto by_score_desc = greater<pair<double, int>>();
+    if (top_k > 0 && top_k < ranked.size()) {
+        partial_sort(ranked.begin(), ranked.begin() + top_k, ranked.end(), by_score_desc);
+        ranked.resize(top_k);
+    } else {
+        parallelSort(ranked, by_score_desc, sort_threads);
+    }
+
+    // Rows are formatted with to_chars into a large buffer that is flushed
+    // in big writes; "%g"-style precision 6 matches the default ostream output
+    ofstream file(filename, ios::binary);
+    const size_t flush_at = 1 << 20;
+    string buf;
+    buf.reserve(flush_at + 4096);
+    buf += "Rank,NodeID,Score,Status\n";
+
+    char num[64];
+    long long bytes_written = 0;
+    for (size_t i = 0; i < ranked.size(); ++i) {
+        int id = ranked[i].second;
+        double score = ranked[i].first;
+
+        buf.append(num, to_chars(num, num + sizeof(num), i + 1).ptr);
+        buf += ',';
+        mapper.appendName(buf, id);
+        buf += ',';
+        buf.append(num, to_chars(num, num + sizeof(num), score, chars_format::general, 6).ptr);
+        buf += binary_search(sorted_seeds.begin(), sorted_seeds.end(), id) ? ",Seed\n" : (score > 0.0001 ? ",Suspicious\n" : ",Safe\n");
+
+        if (buf.size() >= flush_at) {
+            file.write(buf.data(), buf.size());
+            bytes_written += buf.size();
+            buf.clear();
+        }
+    }
+    file.write(buf.data(), buf.size());
+    bytes_written += buf.size();
+    Profiler::instance().addCounter("output.bytes_written", bytes_written);
+
+    file.close();
+    logLine("-> Saved results to: " + filename);
+}
+
+// Dense scores: by default every node is written; with min_score >= 0 only
+// rows strictly above it are (min_score = 0 emits the non-zero rows), and
+// top_k > 0 limits the output to the k highest-ranked rows
+void saveToCSV(const string& filename,
+               const vector<double>& scores,
+               const NodeMapper& mapper,
+               const vector<int>& seeds,
+               double min_score = -1.0,
+               size_t top_k = 0,
+               int sort_threads = 1) {
+
+    vector<pair<double, int>> ranked;
+    ranked.reserve(scores.size());
+    for (size_t i = 0; i < scores.size(); ++i)
+        if (scores[i] > min_score) ranked.push_back({scores[i], i});
+
+    writeRankedCSV(filename, ranked, mapper, seeds, top_k, sort_threads);
+}
+
+// Sparse scores: only the stored entries (above min_score) are written
+void saveToCSV(const string& filename,
+               const SparseScores& scores,
+               const NodeMapper& mapper,
+               const vector<int>& seeds,
+               double min_score = -1.0,
+               size_t top_k = 0,
+               int sort_threads = 1) {
+
+    vector<pair<double, int>> ranked;
+    ranked.reserve(scores.size());
+    for (auto& e : scores)
+        if (e.second > min_score) ranked.push_back({e.second, e.first});
+
+    writeRankedCSV(filename, ranked, mapper, seeds, top_k, sort_threads);
+}
+
+void saveToCSV(const string& filename,
+               const AlgorithmResult& result,
+               const NodeMapper& mapper,
+               const vector<int>& seeds,
+               double min_score = -1.0,
+               size_t top_k = 0,
+               int sort_threads = 1) {
+    if (result.is_sparse) saveToCSV(filename, result.sparse_scores, mapper, seeds, min_score, top_k, sort_threads);
+    else saveToCSV(filename, result.scores, mapper, seeds, min_score, top_k, sort_threads);
+}
+
 // =========================================================
-// SECTION 1: Core Data Structures
+// Utility: Columnar Binary Results
 // =========================================================
 
-// Maps string-based node identifiers to compact integer IDs
-// This reduces memory usage and speeds up graph processing
-class NodeMapper {
-    unordered_map<string, int> name_to_id;
-    vector<string> id_to_name;
+// Self-describing column file holding every result of a run:
+//   char   magic[8]     "PPRCOL1"
+//   uint64 meta_len     length of the JSON metadata that follows
+//   char   meta[...]    {"num_rows":N,"columns":[{"name","type","offset","length",...}]}
+//   ...    column data, each section 64-byte aligned (offsets are absolute)
+// Types: int32, float64, uint8 and dict_utf8 (int32 indices plus a
+// dictionary stored as uint64 offsets[count+1] and concatenated UTF-8
+// bytes). Everything is little-endian, so readers can memory-map the file
+// and view columns in place (see plots/columnar.py).
+class ColumnarWriter {
+    struct Column {
+        string name, type;
+        string data;            // raw column bytes
+        string dict_offsets;    // dict_utf8 only
+        string dict_bytes;      // dict_utf8 only
+        size_t dict_count = 0;
 
-public:
-    // Returns the ID of a node, creating it if it does not exist
-    int getId(const string& name) {
-        if (name_to_id.find(name) == name_to_id.end()) {
-            int new_id = id_to_name.size();
-            name_to_id[name] = new_id;
-            id_to_name.push_back(name);
-            return new_id;
-        }
-        return name_to_id[name];
+        Column(const string& n, const string& t, string d) : name(n), type(t), data(move(d)) {}
+    };
+    size_t num_rows;
+    vector<Column> columns;
+
+    template <typename T>
+    static string toBytes(const vector<T>& v) {
+        return string((const char*)v.data(), v.size() * sizeof(T));
     }
 
-    // Converts numeric ID back to original node name
-    string getName(int id) const {
-        return (id >= 0 && id < id_to_name.size()) ? id_to_name[id] : "UNKNOWN";
+public:
+    // Status codes stored in uint8 status columns
+    enum Status : uint8_t { SAFE = 0, SUSPICIOUS = 1, SEED = 2 };
+
+    explicit ColumnarWriter(size_t rows) : num_rows(rows) {}
+
+    void addInt32(const string& name, const vector<int32_t>& v) {
+        columns.push_back({name, "int32", toBytes(v)});
+    }
+    void addFloat64(const string& name, const vector<double>& v) {
+        columns.push_back({name, "float64", toBytes(v)});
+    }
+    void addUInt8(const string& name, const vector<uint8_t>& v) {
+        columns.push_back({name, "uint8", toBytes(v)});
+    }
+    void addDictionary(const string& name, const vector<int32_t>& indices,
+                       const vector<string>& dictionary) {
+        Column c{name, "dict_utf8", toBytes(indices)};
+        vector<uint64_t> offs = {0};
+        for (const string& s : dictionary) {
+            c.dict_bytes += s;
+            offs.push_back(c.dict_bytes.size());
+        }
+        c.dict_offsets = toBytes(offs);
+        c.dict_count = dictionary.size();
+        columns.push_back(move(c));
     }
 
-    int getNumNodes() const { return id_to_name.size(); }
+    // Score column plus its status column (same rules as the CSV output)
+    void addResult(const string& label, const AlgorithmResult& result,
+                   const vector<int>& seeds) {
+        vector<double> scores(num_rows, 0.0);
+        if (result.is_sparse) {
+            for (auto& e : result.sparse_scores) scores[e.first] = e.second;
+        } else {
+            copy(result.scores.begin(), result.scores.begin() + min(num_rows, result.scores.size()),
+                 scores.begin());
+        }
+        vector<uint8_t> status(num_rows);
+        for (size_t i = 0; i < num_rows; ++i) status[i] = scores[i] > 0.0001 ? SUSPICIOUS : SAFE;
+        for (int id : seeds)
+            if (id >= 0 && (size_t)id < num_rows) status[id] = SEED;
 
-    // Utility function: selects a random node name (used for auto seed selection)
-    string getRandomNodeName() {
-        if (id_to_name.empty()) return "";
-        return id_to_name[rand() % id_to_name.size()];
+        addFloat64("score_" + label, scores);
+        addUInt8("status_" + label, status);
     }
-};
 
-// Compressed Sparse Row (CSR) representation for directed weighted graphs
-struct CSRGraph {
-    int num_nodes;
-    int num_edges;
+    bool write(const string& filename) const {
+        ScopedTimer timer("output.binary");
+        auto align = [](size_t x) { return (x + 63) & ~(size_t)63; };
 
-    vector<int> row_ptr;          // Start index of outgoing edges per node
-    vector<int> col_indices;      // Destination node IDs
-    vector<double> edge_weights;  // Edge weights
-    vector<double> out_weight_sum;// Sum of outgoing weights per node
+        // Offsets depend on the metadata length, which depends on the offsets'
+        // digits; iterate until the layout is stable (converges in <= 3 rounds)
+        string meta;
+        size_t data_start = 0;
+        for (int round = 0; round < 8; ++round) {
+            size_t pos = data_start;
+            stringstream js;
+            js << "{\"num_rows\":" << num_rows << ",\"columns\":[";
+            for (size_t i = 0; i < columns.size(); ++i) {
+                const Column& c = columns[i];
+                js << (i ? "," : "") << "{\"name\":\"" << c.name << "\",\"type\":\"" << c.type
+                   << "\",\"offset\":" << pos << ",\"length\":" << c.data.size();
+                pos = align(pos + c.data.size());
+                if (c.type == "dict_utf8") {
+                    js << ",\"dict_count\":" << c.dict_count
+                       << ",\"dict_offsets\":" << pos;
+                    pos = align(pos + c.dict_offsets.size());
+                    js << ",\"dict_data\":" << pos << ",\"dict_length\":" << c.dict_bytes.size();
+                    pos = align(pos + c.dict_bytes.size());
+                }
+                js << "}";
+            }
+            js << "]}";
+            meta = js.str();
+            size_t start = align(16 + meta.size());
+            if (start == data_start) break;
+            data_start = start;
+        }
 
-    CSRGraph(int n) : num_nodes(n), num_edges(0) {
-        row_ptr.resize(n + 1, 0);
-        out_weight_sum.resize(n, 0.0);
+        ofstream file(filename, ios::binary);
+        if (!file.is_open()) return false;
+        uint64_t meta_len = meta.size();
+        file.write("PPRCOL1\0", 8);
+        file.write((const char*)&meta_len, 8);
+        file.write(meta.data(), meta.size());
+
+        size_t written = 16 + meta.size();
+        auto section = [&](const string& bytes) {
+            static const char zeros[64] = {0};
+            file.write(zeros, align(written) - written);
+            written = align(written);
+            file.write(bytes.data(), bytes.size());
+            written += bytes.size();
+        };
+        for (const Column& c : columns) {
+            section(c.data);
+            if (c.type == "dict_utf8") {
+                section(c.dict_offsets);
+                section(c.dict_bytes);
+            }
+        }
+        file.close();
+        Profiler::instance().addCounter("output.bytes_written", written);
+        logLine("-> Saved columnar results to: " + filename);
+        return file.good();
     }
 };
 
-// =========================================================
-// Graph Loader (Supports Weighted & Unweighted Datasets)
-// =========================================================
-
-CSRGraph loadGraphFromFile(const string& filename, NodeMapper& mapper) {
+// Loads a previous score vector from a results CSV (Rank,NodeID,Score,Status),
+// remapping node names to the current IDs. Nodes missing from the old file
+// get 0; names no longer in the graph are skipped. Returns the number of
+// rows that matched a current node (0 if the file could not be read).
+int loadScoresFromCSV(const string& filename, const NodeMapper& mapper,
+                      vector<double>& scores) {
+    scores.assign(mapper.getNumNodes(), 0.0);
     ifstream file(filename);
-    if (!file.is_open()) {
-        cerr << "Error: File '" << filename << "' not found!" << endl;
-        exit(1);
-    }
+    if (!file.is_open()) return 0;
 
-    struct Edge { int u, v; double w; };
-    vector<Edge> temp_edges;
     string line;
+    getline(file, line); // header
+    int matched = 0;
 
-    cout << "[Loader] Reading dataset..." << endl;
-
-    // Read dataset line-by-line (robust to comments and blank lines)
     while (getline(file, line)) {
-        if (line.empty() || line[0] == '#' || line[0] == '%') continue;
-
         stringstream ss(line);
-        string u_str, v_str;
-        double weight = 1.0; // Default weight for unweighted graphs
-
-        if (ss >> u_str >> v_str) {
-            // Optional third column: edge weight
-            double w_in;
-            if (ss >> w_in) weight = fabs(w_in);
+        string rank, name, score;
+        if (!getline(ss, rank, ',') || !getline(ss, name, ',') || !getline(ss, score, ','))
+            continue;
+        int id = mapper.findId(name);
+        if (id < 0 || id >= (int)scores.size()) continue;
+        scores[id] = atof(score.c_str());
+        matched++;
+    }
+    return matched;
+}
 
-            // Prevent zero-weight edges (numerical stability)
-            if (weight == 0) weight = 0.0001;
+// Writes the per-iteration convergence trace as CSV or JSON
+void saveTrace(const string& filename, const AlgorithmResult& result, bool as_json) {
+    ofstream file(filename);
+    file << setprecision(10);
 
-            int u = mapper.getId(u_str);
-            int v = mapper.getId(v_str);
-            temp_edges.push_back({u, v, weight});
+    if (as_json) {
+        file << "{\"iterations\":" << result.iterations
+             << ",\"converged\":" << (result.converged ? "true" : "false")
+             << ",\"stop_reason\":\"" << result.stop_reason << "\""
+             << ",\"duration_us\":" << result.duration_us;
+        if (result.hw.available()) result.hw.writeJSONFields(file);
+        file << ",\"trace\":[";
+        for (size_t i = 0; i < result.trace.size(); ++i) {
+            const IterationTrace& t = result.trace[i];
+            file << (i ? "," : "") << "\n  {\"iteration\":" << t.iteration
+                 << ",\"residual_l1\":" << t.residual_l1
+                 << ",\"residual_linf\":" << t.residual_linf
+                 << ",\"elapsed_us\":" << t.elapsed_us
+                 << ",\"bytes_touched\":" << t.bytes_touched;
+            if (t.hw.available()) t.hw.writeJSONFields(file);
+            file << "}";
+        }
+        file << "\n]}\n";
+    } else {
+        // Counter columns only appear when counters were collected
+        bool hw = result.hw.available();
+        file << "Iteration,ResidualL1,ResidualLInf,ElapsedUs,BytesTouched";
+        if (hw) file << ",Cycles,Instructions,LLCMisses,DTLBMisses,BranchMisses";
+        file << "\n";
+        for (const IterationTrace& t : result.trace) {
+            file << t.iteration << "," << t.residual_l1 << "," << t.residual_linf
+                 << "," << t.elapsed_us << "," << t.bytes_touched;
+            if (hw)
+                file << "," << t.hw.cycles << "," << t.hw.instructions << "," << t.hw.llc_misses
+                     << "," << t.hw.dtlb_misses << "," << t.hw.branch_misses;
+            file << "\n";
         }
     }
+
     file.close();
+    logLine("-> Saved trace to: " + filename);
+}
 
-    int N = mapper.getNumNodes();
-    vector<vector<pair<int, double>>> adj(N);
+// =========================================================
+// Utility: Thread Pool & Asynchronous Writer
+// =========================================================
 
-    // Build adjacency list
-    for (const auto& e : temp_edges)
-        adj[e.u].push_back({e.v, e.w});
+// Fixed-size pool running independent (engine, alpha) jobs
+class ThreadPool {
+    vector<thread> workers;
+    queue<function<void()>> tasks;
+    mutex m;
+    condition_variable cv;
+    bool stopping = false;
 
-    // Convert adjacency list to CSR format
-    CSRGraph graph(N);
-    graph.num_edges = temp_edges.size();
-    int cursor = 0;
+public:
+    explicit ThreadPool(int num_threads) {
+        for (int t = 0; t < max(1, num_threads); ++t)
+            workers.emplace_back([this] {
+                while (true) {
+                    function<void()> task;
+                    {
+                        unique_lock<mutex> lock(m);
+                        cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+                        if (tasks.empty()) return;
+                        task = move(tasks.front());
+                        tasks.pop();
+                    }
+                    task();
+                }
+            });
+    }
 
-    for (int i = 0; i < N; ++i) {
-        graph.row_ptr[i] = cursor;
-        double sum_w = 0.0;
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& w : workers) w.join();
+    }
 
-        for (auto& nbr : adj[i]) {
-            graph.col_indices.push_back(nbr.first);
-            graph.edge_weights.push_back(nbr.second);
-            sum_w += nbr.second;
-            cursor++;
+    template <typename Fn>
+    future<void> submit(Fn fn) {
+        auto task = make_shared<packaged_task<void()>>(move(fn));
+        future<void> done = task->get_future();
+        {
+            lock_guard<mutex> lock(m);
+            tasks.push([task] { (*task)(); });
         }
-        graph.out_weight_sum[i] = sum_w;
+        cv.notify_one();
+        return done;
     }
-    graph.row_ptr[N] = cursor;
+};
 
-    return graph;
-}
+// Single background thread that performs output writes in FIFO order,
+// so compute jobs never wait for the disk
+class AsyncWriter {
+    ThreadPool pool{1};
+    vector<future<void>> pending;
+    mutex m;
+
+public:
+    template <typename Fn>
+    void enqueue(Fn fn) {
+        lock_guard<mutex> lock(m);
+        pending.push_back(pool.submit(move(fn)));
+    }
+
+    // Blocks until every queued write has finished
+    void flush() {
+        lock_guard<mutex> lock(m);
+        for (auto& f : pending) f.get();
+        pending.clear();
+    }
+};
 
 // =========================================================
-// SECTION 2: Algorithms
+// SECTION 3: Benchmark Suite
 // =========================================================
 
-struct AlgorithmResult {
-    vector<double> scores;     // Final suspicion scores
-    long long duration_us;     // Execution time
-    int iterations;            // Iteration count / walks
-};
+// ---------- Synthetic Graph Generators (reproducible via seed) ----------
 
-// ---------- Personalized PageRank (Exact / Power Iteration) ----------
+using EdgeList = vector<pair<int, int>>;
 
-class PPREngine {
-public:
-    static AlgorithmResult compute(const CSRGraph& graph,
-                                   const vector<int>& seeds,
-                                   double alpha,
-                                   double epsilon) {
-        auto start = high_resolution_clock::now();
-        int N = graph.num_nodes;
+// Erdos-Renyi G(n, m): m directed edges between uniformly random endpoints
+EdgeList generateErdosRenyi(int n, long long m, uint64_t seed) {
+    mt19937_64 gen(seed);
+    uniform_int_distribution<int> node(0, n - 1);
+    EdgeList edges;
+    edges.reserve(m);
+    for (long long i = 0; i < m; ++i) edges.push_back({node(gen), node(gen)});
+    return edges;
+}
 
-        // Personalization vector (probability mass on seed nodes)
-        vector<double> p(N, 0.0);
-        if (!seeds.empty()) {
-            double mass = 1.0 / seeds.size();
-            for (int id : seeds) if (id < N) p[id] = mass;
+// Barabasi-Albert preferential attachment: every new node links to
+// m_per_node existing nodes chosen proportionally to their degree
+EdgeList generateBarabasiAlbert(int n, int m_per_node, uint64_t seed) {
+    mt19937_64 gen(seed);
+    EdgeList edges;
+    vector<int> endpoints;   // each node appears once per incident edge
+    int core = max(2, m_per_node);
+    for (int u = 1; u < min(core, n); ++u) {
+        edges.push_back({u, u - 1});
+        endpoints.push_back(u);
+        endpoints.push_back(u - 1);
+    }
+    for (int u = core; u < n; ++u) {
+        for (int k = 0; k < m_per_node; ++k) {
+            int v = endpoints[uniform_int_distribution<size_t>(0, endpoints.size() - 1)(gen)];
+            edges.push_back({u, v});
+            endpoints.push_back(u);
+            endpoints.push_back(v);
         }
+    }
+    return edges;
+}
 
-        vector<double> r = p, r_new(N);
-        int iter_count = 0;
+// R-MAT (recursive Kronecker) with the usual (0.57, 0.19, 0.19, 0.05)
+// quadrant probabilities; ids beyond n are folded back with a modulo
+EdgeList generateRMAT(int n, long long m, uint64_t seed) {
+    mt19937_64 gen(seed);
+    uniform_real_distribution<double> prob(0.0, 1.0);
+    int scale = 1;
+    while ((1LL << scale) < n) scale++;
+    EdgeList edges;
+    edges.reserve(m);
+    for (long long i = 0; i < m; ++i) {
+        long long u = 0, v = 0;
+        for (int bit = 0; bit < scale; ++bit) {
+            // Quadrants: a=(0,0) 0.57, b=(0,1) 0.19, c=(1,0) 0.19, d=(1,1) 0.05
+            double r = prob(gen);
+            int row = (r >= 0.76) ? 1 : 0;
+            int col = (r >= 0.57 && r < 0.76) || r >= 0.95 ? 1 : 0;
+            u = (u << 1) | row;
+            v = (v << 1) | col;
+        }
+        edges.push_back({(int)(u % n), (int)(v % n)});
+    }
+    return edges;
+}
 
-        // Power Iteration loop
-        for (int iter = 0; iter < 100; ++iter) {
-            fill(r_new.begin(), r_new.end(), 0.0);
-            double dead_mass = 0.0;
-
-            // Push scores to outgoing neighbors
-            for (int u = 0; u < N; ++u) {
-                if (graph.out_weight_sum[u] > 0) {
-                    for (int k = graph.row_ptr[u]; k < graph.row_ptr[u+1]; ++k) {
-                        int v = graph.col_indices[k];
-                        double w = graph.edge_weights[k];
-                        r_new[v] += r[u] * (w / graph.out_weight_sum[u]);
-                    }
-                } else {
-                    // Handle dead-end nodes
-                    dead_mass += r[u];
-                }
-            }
+EdgeList generateGraph(const string& kind, int n, int avg_degree, uint64_t seed) {
+    if (kind == "er") return generateErdosRenyi(n, (long long)n * avg_degree, seed);
+    if (kind == "ba") return generateBarabasiAlbert(n, avg_degree, seed);
+    return generateRMAT(n, (long long)n * avg_degree, seed);
+}
 
-            // Teleportation and convergence check
-            double diff = 0.0;
-            for (int i = 0; i < N; ++i) {
-                double val = (1.0 - alpha) * r_new[i]
-                           + alpha * p[i]
-                           + (1.0 - alpha) * dead_mass * p[i];
-                diff += fabs(val - r[i]);
-                r_new[i] = val;
-            }
+void writeEdgeList(const string& filename, const EdgeList& edges) {
+    ofstream file(filename, ios::binary);
+    string buf;
+    char num[16];
+    for (auto& e : edges) {
+        buf.append(num, to_chars(num, num + sizeof(num), e.first).ptr);
+        buf += ' ';
+        buf.append(num, to_chars(num, num + sizeof(num), e.second).ptr);
+        buf += '\n';
+        if (buf.size() >= (1 << 20)) { file.write(buf.data(), buf.size()); buf.clear(); }
+    }
+    file.write(buf.data(), buf.size());
+}
 
-            r = r_new;
-            iter_count = iter + 1;
-            if (diff < epsilon) break;
-        }
+// ---------- Benchmark Runner ----------
 
-        auto end = high_resolution_clock::now();
-        return {r, duration_cast<microseconds>(end - start).count(), iter_count};
-    }
+struct BenchConfig {
+    vector<string> generators = {"rmat", "ba", "er"};
+    vector<int> sizes = {1000, 10000, 100000};
+    vector<int> threads = {1};
+    int avg_degree = 8;
+    int walks_per_node = 10;
+    uint64_t seed = 42;
+    string output = "bench.json";
 };
 
-// ---------- Monte Carlo Approximation (Bonus Method) ----------
+// One measured phase of one benchmark configuration
+struct BenchRecord {
+    string generator, phase;
+    int nodes;
+    long long edges;
+    int threads;
+    double alpha;              // 0 for phases without a damping factor
+    long long time_us;
+    long long iterations;
+    long long peak_rss_kb;     // peak RSS during this phase (see runBenchmarks)
+    HwCounts hw = {};
+};
 
-class MonteCarloEngine {
-public:
-    static AlgorithmResult compute(const CSRGraph& graph,
-                                   const vector<int>& seeds,
-                                   double alpha,
-                                   int total_walks) {
-        auto start = high_resolution_clock::now();
-        int N = graph.num_nodes;
-        vector<int> visits(N, 0);
+string benchRecordJSON(const BenchRecord& r) {
+    bool iterative = (r.phase == "ppr" || r.phase == "gauss-seidel");
+    double work = iterative ? (double)r.edges * r.iterations : (double)r.edges;
+    double eps = r.time_us > 0 ? work * 1e6 / r.time_us : 0.0;
+    stringstream row;
+    row << "{\"generator\":\"" << r.generator
+        << "\",\"phase\":\"" << r.phase
+        << "\",\"nodes\":" << r.nodes << ",\"edges\":" << r.edges
+        << ",\"threads\":" << r.threads << ",\"alpha\":" << r.alpha
+        << ",\"time_us\":" << r.time_us << ",\"edges_per_sec\":" << (long long)eps
+        << ",\"iterations\":" << r.iterations
+        << ",\"peak_rss_kb\":" << r.peak_rss_kb;
+    r.hw.writeJSONFields(row);
+    row << "}";
+    return row.str();
+}
 
-        if (seeds.empty()) return {vector<double>(N, 0.0), 0, 0};
+void saveBenchJSON(const string& filename, const vector<string>& rows) {
+    ofstream file(filename);
+    file << "{\"records\":[";
+    for (size_t i = 0; i < rows.size(); ++i) file << (i ? "," : "") << "\n  " << rows[i];
+    file << "\n]}\n";
+    logLine("-> Saved benchmark results to: " + filename);
+}
 
-        random_device rd;
-        mt19937 gen(rd());
-        uniform_real_distribution<> prob(0.0, 1.0);
-        uniform_int_distribution<> seed_dist(0, seeds.size() - 1);
+// Times the loader, both exact solvers, Monte Carlo and the CSV writer on
+// one generated graph for every thread count. peak_rss_kb is the peak RSS
+// of each phase: the high-water mark is reset before it, so it covers
+// what is resident then (the loaded graph, heap kept by earlier phases)
+// plus what the phase allocates.
+static void runBenchConfig(const BenchConfig& bench, const ConvergencePolicy& policy,
+                           const string& kind, int n, vector<BenchRecord>& records) {
+    const string graph_file = "bench_tmp_graph.txt";
+    const string csv_file = "bench_tmp_results.csv";
+    const vector<double> alphas = {0.15, 0.50, 0.85};
 
-        // Random walk simulation
-        for (int i = 0; i < total_walks; ++i) {
-            int curr = seeds[seed_dist(gen)];
+    bool per_phase_rss = resetPeakRSS() && phasePeakRSSKilobytes() >= 0;
+    if (!per_phase_rss)
+        logLine("[Bench] Cannot reset the peak RSS: peak_rss_kb is the peak of the whole configuration");
+    auto startPhase = [&] { if (per_phase_rss) resetPeakRSS(); };
+    auto phasePeak = [&] { return per_phase_rss ? phasePeakRSSKilobytes() : peakRSSKilobytes(); };
 
-            while (true) {
-                visits[curr]++;
+    EdgeList edges = generateGraph(kind, n, bench.avg_degree, bench.seed);
+    writeEdgeList(graph_file, edges);
+    long long E = edges.size();
+    EdgeList().swap(edges);
 
-                // Teleport / stop condition
-                if (prob(gen) < alpha) break;
-                if (graph.out_weight_sum[curr] == 0) break;
+    // Loader scaling: each thread count parses the file from scratch;
+    // the last graph is kept for the engines
+    unique_ptr<NodeMapper> mapper;
+    CSRGraph graph(0);
+    for (int T : bench.threads) {
+        graph = CSRGraph(0);   // the previous load must not count towards this one
+        mapper.reset();
+        startPhase();
+        auto t0 = high_resolution_clock::now();
+        auto loaded_mapper = make_unique<NodeMapper>();
+        CSRGraph loaded = loadGraphFromFile(graph_file, *loaded_mapper, T);
+        long long load_us = duration_cast<microseconds>(high_resolution_clock::now() - t0).count();
+        records.push_back({kind, "load", loaded.num_nodes, E, T, 0.0, load_us, 0, phasePeak()});
+        graph = move(loaded);
+        mapper = move(loaded_mapper);
+    }
+    remove(graph_file.c_str());
 
-                // Weighted neighbor selection
-                double target = prob(gen) * graph.out_weight_sum[curr];
-                double acc = 0.0;
+    vector<int> seeds;
+    for (int s = 0; s < min(3, graph.num_nodes); ++s) seeds.push_back(s);
 
-                for (int k = graph.row_ptr[curr]; k < graph.row_ptr[curr+1]; ++k) {
-                    acc += graph.edge_weights[k];
-                    if (target <= acc) {
-                        curr = graph.col_indices[k];
-                        break;
-                    }
+    // Power iteration and Monte Carlo are single-threaded: one row per alpha
+    vector<AlgorithmResult> ppr_results;
+    for (double alpha : alphas) {
+        startPhase();
+        ppr_results.push_back(PPREngine::compute(graph, seeds, alpha, policy));
+        const AlgorithmResult& ppr = ppr_results.back();
+        records.push_back({kind, "ppr", graph.num_nodes, E, 1, alpha,
+                           ppr.duration_us, ppr.iterations, phasePeak(), ppr.hw});
+
+        startPhase();
+        auto mc = MonteCarloEngine::compute(graph, seeds, alpha,
+                                            (long long)graph.num_nodes * bench.walks_per_node);
+        records.push_back({kind, "mc", graph.num_nodes, E, 1, alpha,
+                           mc.duration_us, mc.iterations, phasePeak(), mc.hw});
+    }
+
+    // Gauss-Seidel blocks and the CSV sort actually use T threads
+    for (int T : bench.threads) {
+        for (double alpha : alphas) {
+            startPhase();
+            auto gs = PPREngine::computeGaussSeidel(graph, seeds, alpha, policy, T);
+            records.push_back({kind, "gauss-seidel", graph.num_nodes, E, T, alpha,
+                               gs.duration_us, gs.iterations, phasePeak(), gs.hw});
+        }
+        startPhase();
+        auto c0 = high_resolution_clock::now();
+        saveToCSV(csv_file, ppr_results.front(), *mapper, seeds, -1.0, 0, T);
+        long long csv_us = duration_cast<microseconds>(high_resolution_clock::now() - c0).count();
+        records.push_back({kind, "csv", graph.num_nodes, (long long)graph.num_nodes, T, alphas.front(),
+                           csv_us, 0, phasePeak()});
+    }
+    remove(csv_file.c_str());
+
+    stringstream msg;
+    msg << "[Bench] " << kind << " N=" << graph.num_nodes << " E=" << E << " done";
+    logLine(msg.str());
+}
+
+// Runs every (generator, size) configuration in its own child process so
+// memory held by one graph never shows up in another's peak_rss_kb; the
+// child sends its JSON rows back through a pipe. edges_per_sec counts
+// edge visits (edges x iterations) for the iterative solvers; for Monte
+// Carlo 'iterations' is the number of walks.
+int runBenchmarks(const BenchConfig& bench, const ConvergencePolicy& policy) {
+    vector<string> rows;
+    for (const string& kind : bench.generators) {
+        for (int n : bench.sizes) {
+            int fds[2];
+            if (pipe(fds) != 0) {
+                cerr << "Error: cannot create a pipe for the benchmark" << endl;
+                return 1;
+            }
+            cout.flush();
+            pid_t pid = fork();
+            if (pid < 0) {
+                cerr << "Error: cannot fork the benchmark process" << endl;
+                return 1;
+            }
+            if (pid == 0) {
+                ::close(fds[0]);
+                vector<BenchRecord> records;
+                runBenchConfig(bench, policy, kind, n, records);
+                bool ok = true;
+                string out;
+                for (const BenchRecord& r : records) out += benchRecordJSON(r) + "\n";
+                for (size_t done = 0; done < out.size();) {
+                    ssize_t w = write(fds[1], out.data() + done, out.size() - done);
+                    if (w <= 0) { ok = false; break; }
+                    done += w;
                 }
+                ::close(fds[1]);
+                cout.flush();
+                exit(ok ? 0 : 1);
+            }
+
+            ::close(fds[1]);
+            string out;
+            char buf[1 << 16];
+            for (ssize_t got; (got = read(fds[0], buf, sizeof(buf))) > 0;) out.append(buf, got);
+            ::close(fds[0]);
+            int status = 0;
+            waitpid(pid, &status, 0);
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                cerr << "Error: benchmark " << kind << " N=" << n << " failed" << endl;
+                return 1;
             }
+            stringstream lines(out);
+            for (string line; getline(lines, line);) rows.push_back(line);
         }
+    }
+    saveBenchJSON(bench.output, rows);
+    return 0;
+}
 
-        // Normalize visit counts to probabilities
-        vector<double> scores(N, 0.0);
-        long long total = 0;
-        for (int v : visits) total += v;
-        if (total > 0)
-            for (int i = 0; i < N; ++i)
-                scores[i] = (double)visits[i] / total;
+// ---------- Accuracy vs. Cost Harness ----------
 
-        auto end = high_resolution_clock::now();
-        return {scores, duration_cast<microseconds>(end - start).count(), total_walks};
-    }
+struct AccuracyConfig {
+    vector<int> walks_per_node = {1, 5, 10, 50, 100, 500};
+    vector<double> tolerances = {1e-2, 1e-3, 1e-4};
+    int k = 100;
+    string output = "accuracy.csv";
 };
 
-// =========================================================
-// Utility: Save Results to CSV
-// =========================================================
+// Error / ranking metrics of one approximate result against ground truth
+struct AccuracyRecord {
+    string engine, param;
+    double alpha;
+    long long time_us;
+    double l1, max_err, precision_k, ndcg_k, kendall_tau;
+    bool pareto = false;       // not dominated in (time, L1) for this alpha
+};
 
-void saveToCSV(const string& filename,
-               const vector<double>& scores,
-               const NodeMapper& mapper,
-               const vector<int>& seeds) {
+vector<int> topKIds(const vector<double>& scores, int k) {
+    vector<int> ids(scores.size());
+    for (size_t i = 0; i < ids.size(); ++i) ids[i] = i;
+    k = min<int>(k, ids.size());
+    partial_sort(ids.begin(), ids.begin() + k, ids.end(), [&](int a, int b) {
+        return scores[a] != scores[b] ? scores[a] > scores[b] : a < b;
+    });
+    ids.resize(k);
+    return ids;
+}
 
-    ofstream file(filename);
-    file << "Rank,NodeID,Score,Status\n";
+AccuracyRecord compareToTruth(const string& engine, const string& param, double alpha,
+                              const AlgorithmResult& approx_result,
+                              const vector<double>& truth, const vector<int>& truth_top, int k) {
+    int N = truth.size();
+    vector<double> approx(N, 0.0);
+    for (int i = 0; i < N; ++i) approx[i] = approx_result.scoreOf(i);
 
-    vector<pair<double, int>> ranked;
-    for (size_t i = 0; i < scores.size(); ++i)
-        ranked.push_back({scores[i], i});
+    AccuracyRecord rec{engine, param, alpha, approx_result.duration_us, 0, 0, 0, 0, 0};
+    for (int i = 0; i < N; ++i) {
+        double err = fabs(approx[i] - truth[i]);
+        rec.l1 += err;
+        rec.max_err = max(rec.max_err, err);
+    }
 
-    sort(ranked.rbegin(), ranked.rend());
+    // precision@k: overlap of the two top-k sets
+    vector<int> approx_top = topKIds(approx, k);
+    vector<char> in_truth(N, 0);
+    for (int id : truth_top) in_truth[id] = 1;
+    int hits = 0;
+    for (int id : approx_top) hits += in_truth[id];
+    int kk = truth_top.size();
+    rec.precision_k = kk ? (double)hits / kk : 1.0;
 
-    for (size_t i = 0; i < ranked.size(); ++i) {
-        int id = ranked[i].second;
-        bool is_seed = find(seeds.begin(), seeds.end(), id) != seeds.end();
+    // NDCG@k with the true scores as graded relevance
+    double dcg = 0.0, idcg = 0.0;
+    for (int i = 0; i < kk; ++i) {
+        dcg += truth[approx_top[i]] / log2(i + 2.0);
+        idcg += truth[truth_top[i]] / log2(i + 2.0);
+    }
+    rec.ndcg_k = idcg > 0 ? dcg / idcg : 1.0;
+
+    // Kendall tau-b over the true top-k nodes
+    long long concordant = 0, discordant = 0, ties_t = 0, ties_a = 0;
+    for (int i = 0; i < kk; ++i)
+        for (int j = i + 1; j < kk; ++j) {
+            double dt = truth[truth_top[i]] - truth[truth_top[j]];
+            double da = approx[truth_top[i]] - approx[truth_top[j]];
+            if (dt == 0 && da == 0) continue;
+            if (dt == 0) ties_t++;
+            else if (da == 0) ties_a++;
+            else if ((dt > 0) == (da > 0)) concordant++;
+            else discordant++;
+        }
+    double denom = sqrt((double)(concordant + discordant + ties_t) * (concordant + discordant + ties_a));
+    rec.kendall_tau = denom > 0 ? (concordant - discordant) / denom : 1.0;
+    return rec;
+}
+
+// Runs exact PPR at a very tight tolerance as ground truth, then sweeps the
+// approximate engines (Monte Carlo walk counts, optionally with the hub
+// index, and loose-tolerance power iteration) and writes one row per
+// setting. Rows flagged pareto=1 form the time-vs-L1 Pareto curve.
+int runAccuracyHarness(const CSRGraph& graph, const vector<int>& seeds,
+                       const AccuracyConfig& acc, const string& hub_prefix, int num_hubs) {
+    vector<AccuracyRecord> records;
+    const vector<double> alphas = {0.15, 0.50, 0.85};
+
+    for (double alpha : alphas) {
+        ConvergencePolicy exact(1e-12);
+        exact.max_iterations = 10000;
+        AlgorithmResult truth = PPREngine::compute(graph, seeds, alpha, exact);
+        vector<int> truth_top = topKIds(truth.scores, acc.k);
+        size_t first = records.size();
+
+        for (double tol : acc.tolerances) {
+            stringstream param;
+            param << "tol=" << tol;
+            auto res = PPREngine::compute(graph, seeds, alpha, ConvergencePolicy(tol));
+            records.push_back(compareToTruth("ppr", param.str(), alpha, res, truth.scores, truth_top, acc.k));
+        }
+
+        HubIndex hub_index;
+        if (num_hubs > 0) {
+            string index_file = hub_prefix + ".hubs_alpha_" + to_string((int)(alpha * 100));
+            if (!hub_index.load(index_file, graph) || hub_index.numHubs() != min(num_hubs, graph.num_nodes)
+                || fabs(hub_index.alpha() - alpha) > 1e-12) {
+                HubIndex::build(graph, alpha, num_hubs, 10000, index_file);
+                hub_index.load(index_file, graph);
+            }
+        }
 
-        string status = is_seed ? "Seed"
-                        : (ranked[i].first > 0.0001 ? "Suspicious" : "Safe");
+        for (int w : acc.walks_per_node) {
+            long long walks = max(1LL, (long long)graph.num_nodes * w);
+            string param = "walks_per_node=" + to_string(w);
+            auto mc = MonteCarloEngine::compute(graph, seeds, alpha, walks);
+            records.push_back(compareToTruth("mc", param, alpha, mc, truth.scores, truth_top, acc.k));
+            if (hub_index.numHubs() > 0) {
+                auto mch = MonteCarloEngine::compute(graph, seeds, alpha, walks, &hub_index);
+                records.push_back(compareToTruth("mc-hubs", param, alpha, mch, truth.scores, truth_top, acc.k));
+            }
+        }
 
-        file << (i+1) << "," << mapper.getName(id)
-             << "," << ranked[i].first << "," << status << "\n";
+        // Pareto front in (time, L1) among this alpha's rows
+        for (size_t i = first; i < records.size(); ++i) {
+            records[i].pareto = true;
+            for (size_t j = first; j < records.size(); ++j)
+                if (j != i && records[j].time_us <= records[i].time_us && records[j].l1 <= records[i].l1
+                    && (records[j].time_us < records[i].time_us || records[j].l1 < records[i].l1)) {
+                    records[i].pareto = false;
+                    break;
+                }
+        }
+        stringstream msg;
+        msg << "[Accuracy] alpha=" << alpha << " ground truth in " << truth.iterations << " iterations";
+        logLine(msg.str());
     }
 
+    ofstream file(acc.output);
+    file << setprecision(8);
+    file << "Engine,Param,Alpha,TimeUs,L1,MaxError,PrecisionAtK,NDCGAtK,KendallTau,Pareto\n";
+    for (const AccuracyRecord& r : records)
+        file << r.engine << "," << r.param << "," << r.alpha << "," << r.time_us << ","
+             << r.l1 << "," << r.max_err << "," << r.precision_k << "," << r.ndcg_k << ","
+             << r.kendall_tau << "," << (r.pareto ? 1 : 0) << "\n";
     file.close();
-    cout << "-> Saved results to: " << filename << endl;
+    logLine("-> Saved accuracy results to: " + acc.output);
+    return 0;
 }
 
 // =========================================================
 // MAIN
 // =========================================================
 
-int main() {
+// Interactive loop: '+name' / '-name' edit the seed set, 'quit' exits.
+// Each query is answered from the per-seed cache, so a one-seed tweak only
+// solves PPR for the seed that was added.
+void exploreSeeds(const CSRGraph& graph, const NodeMapper& mapper,
+                  vector<int> seed_ids, double alpha, PPRCache& cache) {
+    string cmd;
+    while (true) {
+        AlgorithmResult res = cache.compose(graph, seed_ids, alpha);
+
+        vector<pair<double, int>> ranked;
+        for (auto& e : res.sparse_scores) ranked.push_back({e.second, e.first});
+        int k = min<int>(10, ranked.size());
+        partial_sort(ranked.begin(), ranked.begin() + k, ranked.end(), greater<pair<double, int>>());
+
+        cout << "\nTop " << k << " (alpha=" << alpha << ", " << seed_ids.size() << " seeds):\n";
+        for (int i = 0; i < k; ++i)
+            cout << "  " << (i+1) << ". " << mapper.getName(ranked[i].second)
+                 << "  " << ranked[i].first << "\n";
+        cout << "[Cache] hits=" << cache.hits << " misses=" << cache.misses
+             << " entries=" << cache.size() << " size=" << cache.bytesUsed() / 1024 << "KB"
+             << " time=" << res.duration_us << "us\n";
+
+        cout << "explore> ";
+        if (!(cin >> cmd) || cmd == "quit" || cmd == "done") break;
+        if (cmd.size() < 2 || (cmd[0] != '+' && cmd[0] != '-')) {
+            cout << "Use +name, -name or quit\n";
+            continue;
+        }
+        int id = mapper.findId(cmd.substr(1));
+        if (id < 0) { cout << "Unknown node: " << cmd.substr(1) << "\n"; continue; }
+        if (cmd[0] == '+') seed_ids.push_back(id);
+        else seed_ids.erase(remove(seed_ids.begin(), seed_ids.end(), id), seed_ids.end());
+    }
+}
+
+// Command-line options (all optional; dataset and seeds stay interactive)
+struct RunConfig {
+    string solver = "power";   // power | gauss-seidel | bicgstab
+    int threads = 1;           // worker threads for parallel solvers
+    ConvergencePolicy policy;  // stopping rule for the exact solvers
+    string trace_format;       // "", "csv" or "json"
+    string warm_start_dir;     // directory holding previous results_PPR_*.csv
+    bool explore = false;      // interactive seed-set exploration via PPRCache
+    size_t cache_mb = 256;     // memory budget of the per-seed cache
+    size_t cache_top = 10000;  // non-zeros kept per cached seed vector
+    int hubs = 0;              // hub nodes indexed for Monte Carlo (0 = off)
+    bool sparse = false;       // sparse MC engine and sparse (thresholded) output
+    double min_score = -1.0;   // only emit rows above this score (-1 = all rows)
+    size_t csv_top = 0;        // only emit the top-k rows (0 = all rows)
+    string binary_output;      // columnar results file for the whole run ("" = off)
+    int jobs = 0;              // concurrent (engine, alpha) jobs (0 = all cores)
+    bool bench = false;        // run the synthetic benchmark suite instead
+    BenchConfig bench_cfg;
+    int load_threads = 1;      // parser threads for the graph loader
+    EdgePolicy edge_policy;    // parallel-edge merging and self-loop handling
+    bool temporal = false;     // read a timestamp column and decay weights by age
+    int64_t query_time = INT64_MAX; // decay reference (INT64_MAX = newest edge)
+    double half_life = 0.0;    // weight half-life in timestamp units (0 = no decay)
+    string snapshot;           // out-of-core CSR snapshot ("" = parse the text file)
+    size_t mem_budget_mb = 1024; // edge buffer budget for the snapshot builder
+    string tmp_dir = ".";      // where the builder spills sorted runs
+    bool semi_external = false;// stream the snapshot's edges instead of loading them
+    size_t io_block_mb = 16;   // size of each streaming buffer
+    string node_dict;          // mmap-able node dictionary ("" = none)
+    bool hw_counters = false;  // sample perf_event hardware counters
+    bool profile = false;      // print the performance report at exit
+    string profile_trace;      // Chrome trace-event JSON ("" = none)
+    bool accuracy = false;     // run the accuracy-vs-cost harness instead
+    AccuracyConfig accuracy_cfg;
+};
+
+// Parses "a,b,c" into a list of values
+template <typename T>
+vector<T> parseList(const string& text, T (*convert)(const string&)) {
+    vector<T> out;
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ','))
+        if (!item.empty()) out.push_back(convert(item));
+    return out;
+}
+
+RunConfig parseArgs(int argc, char** argv) {
+    RunConfig cfg;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        size_t eq = arg.find('=');
+        string key = arg.substr(0, eq);
+        string val = (eq == string::npos) ? "" : arg.substr(eq + 1);
+
+        if (key == "--solver") cfg.solver = val;
+        else if (key == "--threads") cfg.threads = max(1, atoi(val.c_str()));
+        else if (key == "--max-iter") cfg.policy.max_iterations = max(1, atoi(val.c_str()));
+        else if (key == "--tol") cfg.policy.tolerance = atof(val.c_str());
+        else if (key == "--top-k") cfg.policy.top_k = max(1, atoi(val.c_str()));
+        else if (key == "--time-budget-ms") cfg.policy.time_budget_us = atoll(val.c_str()) * 1000;
+        else if (key == "--criterion") {
+            if (val == "l1") cfg.policy.criterion = ConvergencePolicy::L1;
+            else if (val == "linf") cfg.policy.criterion = ConvergencePolicy::LINF;
+            else if (val == "topk") cfg.policy.criterion = ConvergencePolicy::TOP_K_STABLE;
+            else { cerr << "Error: unknown criterion '" << val << "'" << endl; exit(1); }
+        }
+        else if (key == "--warm-start") cfg.warm_start_dir = val;
+        else if (key == "--explore") cfg.explore = true;
+        else if (key == "--hubs") cfg.hubs = max(0, atoi(val.c_str()));
+        else if (key == "--sparse") cfg.sparse = true;
+        else if (key == "--min-score") cfg.min_score = atof(val.c_str());
+        else if (key == "--csv-top") cfg.csv_top = max(0, atoi(val.c_str()));
+        else if (key == "--binary") cfg.binary_output = val;
+        else if (key == "--jobs") cfg.jobs = max(1, atoi(val.c_str()));
+        else if (key == "--bench") cfg.bench = true;
+        else if (key == "--bench-out") cfg.bench_cfg.output = val;
+        else if (key == "--bench-degree") cfg.bench_cfg.avg_degree = max(1, atoi(val.c_str()));
+        else if (key == "--bench-walks") cfg.bench_cfg.walks_per_node = max(1, atoi(val.c_str()));
+        else if (key == "--bench-seed") cfg.bench_cfg.seed = strtoull(val.c_str(), nullptr, 10);
+        else if (key == "--bench-sizes")
+            cfg.bench_cfg.sizes = parseList<int>(val, [](const string& s) { return max(2, atoi(s.c_str())); });
+        else if (key == "--bench-threads")
+            cfg.bench_cfg.threads = parseList<int>(val, [](const string& s) { return max(1, atoi(s.c_str())); });
+        else if (key == "--snapshot") cfg.snapshot = val;
+        else if (key == "--mem-budget-mb") cfg.mem_budget_mb = max(1, atoi(val.c_str()));
+        else if (key == "--tmp-dir") cfg.tmp_dir = val;
+        else if (key == "--semi-external") cfg.semi_external = true;
+        else if (key == "--io-block-mb") cfg.io_block_mb = max(1, atoi(val.c_str()));
+        else if (key == "--load-threads") cfg.load_threads = max(1, atoi(val.c_str()));
+        else if (key == "--merge-edges") {
+            if (val == "none") cfg.edge_policy.merge = EdgePolicy::NONE;
+            else if (val == "sum") cfg.edge_policy.merge = EdgePolicy::SUM;
+            else if (val == "max") cfg.edge_policy.merge = EdgePolicy::MAX;
+            else if (val == "count") cfg.edge_policy.merge = EdgePolicy::COUNT;
+            else { cerr << "Error: unknown edge merge '" << val << "'" << endl; exit(1); }
+        }
+        else if (key == "--temporal") cfg.temporal = true;
+        else if (key == "--query-time") { cfg.temporal = true; cfg.query_time = atoll(val.c_str()); }
+        else if (key == "--half-life") { cfg.temporal = true; cfg.half_life = atof(val.c_str()); }
+        else if (key == "--self-loops") {
+            if (val == "keep") cfg.edge_policy.drop_self_loops = false;
+            else if (val == "drop") cfg.edge_policy.drop_self_loops = true;
+            else { cerr << "Error: unknown self-loop policy '" << val << "'" << endl; exit(1); }
+        }
+        else if (key == "--node-dict") cfg.node_dict = val;
+        else if (key == "--hw-counters") cfg.hw_counters = true;
+        else if (key == "--profile") cfg.profile = true;
+        else if (key == "--profile-trace") { cfg.profile = true; cfg.profile_trace = val; }
+        else if (key == "--accuracy") cfg.accuracy = true;
+        else if (key == "--accuracy-k") cfg.accuracy_cfg.k = max(1, atoi(val.c_str()));
+        else if (key == "--accuracy-out") cfg.accuracy_cfg.output = val;
+        else if (key == "--accuracy-walks")
+            cfg.accuracy_cfg.walks_per_node = parseList<int>(val, [](const string& s) { return max(1, atoi(s.c_str())); });
+        else if (key == "--accuracy-tols")
+            cfg.accuracy_cfg.tolerances = parseList<double>(val, [](const string& s) { return atof(s.c_str()); });
+        else if (key == "--bench-graphs")
+            cfg.bench_cfg.generators = parseList<string>(val, [](const string& s) { return s; });
+        else if (key == "--cache-mb") cfg.cache_mb = max(1, atoi(val.c_str()));
+        else if (key == "--cache-top") cfg.cache_top = max(1, atoi(val.c_str()));
+        else if (key == "--trace") {
+            if (val != "csv" && val != "json") { cerr << "Error: --trace expects csv or json" << endl; exit(1); }
+            cfg.trace_format = val;
+            cfg.policy.record_trace = true;
+        }
+        else {
+            cerr << "Unknown option: " << arg << endl;
+            exit(1);
+        }
+    }
+    if (cfg.solver != "power" && cfg.solver != "gauss-seidel" && cfg.solver != "bicgstab") {
+        cerr << "Error: unknown solver '" << cfg.solver << "'" << endl;
+        exit(1);
+    }
+    return cfg;
+}
+
+// Power iteration straight from the snapshot. Alphas run one after the
+// other because they share the disk stream; Monte Carlo needs random
+// access to the edges and is skipped.
+int runSemiExternal(SnapshotEdgeStream& stream, const NodeMapper& mapper,
+                    const vector<int>& seed_ids, const RunConfig& cfg) {
+    for (double alpha : {0.15, 0.50, 0.85}) {
+        string suffix = "_" + to_string((int)(alpha * 100)) + ".csv";
+        AlgorithmResult res = SemiExternalPPR::compute(stream, seed_ids, alpha, cfg.policy);
+        if (res.stop_reason == "io_error") {
+            cerr << "Error: read failure while streaming the snapshot" << endl;
+            return 1;
+        }
+        stringstream msg;
+        msg << "[PPR] alpha=" << alpha << " solver=semi-external"
+            << " iterations=" << res.iterations
+            << " time=" << res.duration_us << "us"
+            << " (" << res.stop_reason << ")";
+        logLine(msg.str());
+        if (cfg.sparse) makeSparse(res, max(0.0, cfg.min_score));
+        if (!cfg.trace_format.empty())
+            saveTrace("trace_PPR_alpha_" + to_string((int)(alpha * 100)) + "." + cfg.trace_format,
+                      res, cfg.trace_format == "json");
+        saveToCSV("results_PPR_alpha" + suffix, res, mapper, seed_ids, cfg.min_score, cfg.csv_top,
+                  max(1u, thread::hardware_concurrency()));
+    }
+    logLine("[MC] Skipped: Monte Carlo needs the edges in memory");
+    cout << "\n[Done] All experiments completed successfully.\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
     srand(time(0));
+    RunConfig cfg = parseArgs(argc, argv);
+    Profiler::instance().enabled = cfg.profile;
+    Profiler::instance().trace_file = cfg.profile_trace;
+    HwCounterGroup::enabled() = cfg.hw_counters;
     cout << "=== FRAUD DETECTION SYSTEM (FINAL VERSION) ===\n";
 
+    if (cfg.bench) return runBenchmarks(cfg.bench_cfg, cfg.policy);
+
     string filename;
     cout << "Enter dataset filename: ";
     cin >> filename;
 
     NodeMapper mapper;
-    CSRGraph graph = loadGraphFromFile(filename, mapper);
+    CSRGraph graph(0);
+    SnapshotEdgeStream stream;
+    if (cfg.semi_external && cfg.snapshot.empty()) {
+        cerr << "Error: --semi-external needs --snapshot=FILE" << endl;
+        return 1;
+    }
+    if (cfg.temporal && !cfg.snapshot.empty()) {
+        cerr << "Error: --temporal graphs cannot use --snapshot (no timestamp section)" << endl;
+        return 1;
+    }
+    if (!cfg.snapshot.empty()) {
+        // Reuse the snapshot when present, otherwise build it out of core first
+        if (access(cfg.snapshot.c_str(), R_OK) != 0) {
+            NodeMapper builder;
+            if (!buildCSRSnapshot(filename, cfg.snapshot, builder, cfg.mem_budget_mb << 20, cfg.tmp_dir,
+                                  cfg.edge_policy))
+                return 1;
+        }
+        bool ok = cfg.semi_external
+            ? stream.open(cfg.snapshot, cfg.io_block_mb << 20, cfg.edge_policy) &&
+              mapper.loadDictionary(cfg.snapshot + ".dict") && mapper.getNumNodes() == stream.numNodes()
+            : loadCSRSnapshot(cfg.snapshot, mapper, graph, cfg.edge_policy);
+        if (!ok) {
+            cerr << "Error: could not load snapshot '" << cfg.snapshot << "'" << endl;
+            return 1;
+        }
+        cout << "[Snapshot] " << (cfg.semi_external ? "Streaming " : "Loaded ") << cfg.snapshot << endl;
+    } else {
+        if (!cfg.node_dict.empty() && mapper.loadDictionary(cfg.node_dict))
+            cout << "[Dict] Mapped " << mapper.getNumNodes() << " node names from " << cfg.node_dict << endl;
+        graph = loadGraphFromFile(filename, mapper, cfg.load_threads, cfg.edge_policy, cfg.temporal);
+
+        // Missing, or the graph named nodes outside it: (re)build for next time
+        if (!cfg.node_dict.empty() && !mapper.hasDictionary()) {
+            ScopedTimer timer("dict.build");
+            if (mapper.saveDictionary(cfg.node_dict))
+                cout << "[Dict] Saved node dictionary to: " << cfg.node_dict << endl;
+            else
+                cerr << "Warning: could not write node dictionary '" << cfg.node_dict << "'" << endl;
+        }
+    }
+
+    if (cfg.semi_external)
+        cout << "[Graph] Nodes: " << stream.numNodes()
+             << " | Edges: " << stream.numEdges() << " (on disk)" << endl;
+    else
+        cout << "[Graph] Nodes: " << graph.num_nodes
+             << " | Edges: " << graph.num_edges << endl;
 
-    cout << "[Graph] Nodes: " << graph.num_nodes
-         << " | Edges: " << graph.num_edges << endl;
+    // Temporal graphs: reweight in place for the query time (default: newest edge)
+    string hub_tag;
+    if (cfg.temporal) {
+        if (cfg.query_time == INT64_MAX)
+            cfg.query_time = graph.edge_times.empty() ? 0
+                : *max_element(graph.edge_times.begin(), graph.edge_times.end());
+        long long active = applyTimeDecay(graph, cfg.query_time, cfg.half_life);
+        cout << "[Temporal] Query time " << cfg.query_time << ", half-life " << cfg.half_life
+             << ": " << active << " of " << graph.num_edges << " edges active" << endl;
+        stringstream tag;
+        tag << ".t" << cfg.query_time << "_hl" << setprecision(17) << cfg.half_life;
+        hub_tag = tag.str();
+    }
 
     // Interactive seed selection
     vector<int> seed_ids;
@@ -334,19 +4811,127 @@ int main() {
         return 0;
     }
 
-    long long dynamic_walks = graph.num_nodes * 500;
+    if (cfg.semi_external) return runSemiExternal(stream, mapper, seed_ids, cfg);
+
+    if (cfg.accuracy)
+        return runAccuracyHarness(graph, seed_ids, cfg.accuracy_cfg, filename + hub_tag, cfg.hubs);
+
+    if (cfg.explore) {
+        PPRCache cache(cfg.cache_mb << 20, cfg.cache_top, cfg.policy);
+        exploreSeeds(graph, mapper, seed_ids, 0.15, cache);
+        return 0;
+    }
+
+    long long dynamic_walks = (long long)graph.num_nodes * 500;
     vector<double> alpha_values = {0.15, 0.50, 0.85};
 
-    for (double alpha : alpha_values) {
-        string suffix = "_" + to_string((int)(alpha * 100)) + ".csv";
+    // Optional single columnar file holding every result of this run
+    ColumnarWriter columns(graph.num_nodes);
+    if (!cfg.binary_output.empty()) {
+        vector<int32_t> ids(graph.num_nodes);
+        vector<string> names(graph.num_nodes);
+        for (int i = 0; i < graph.num_nodes; ++i) {
+            ids[i] = i;
+            names[i] = mapper.getName(i);
+        }
+        columns.addInt32("node_id", ids);
+        columns.addDictionary("node_name", ids, names);
+    }
+
+    // Every (engine, alpha) pair is an independent job; results are written
+    // by the async writer as soon as each job finishes
+    int num_jobs = cfg.jobs > 0 ? cfg.jobs : max(1u, thread::hardware_concurrency());
+    // The writer sorts while solver jobs still run: only use the spare cores
+    int sort_threads = max(1, (int)thread::hardware_concurrency() - num_jobs);
+    vector<AlgorithmResult> ppr_results(alpha_values.size()), mc_results(alpha_values.size());
+    AsyncWriter writer;
+    {
+        ThreadPool pool(num_jobs);
+        vector<future<void>> jobs;
+
+        for (size_t a = 0; a < alpha_values.size(); ++a) {
+            double alpha = alpha_values[a];
+            string suffix = "_" + to_string((int)(alpha * 100)) + ".csv";
+
+            jobs.push_back(pool.submit([&, a, alpha, suffix] {
+                // Optional warm start from a previous run's results
+                vector<double> warm;
+                const vector<double>* warm_ptr = nullptr;
+                if (!cfg.warm_start_dir.empty()) {
+                    string prev = cfg.warm_start_dir + "/results_PPR_alpha" + suffix;
+                    int matched = loadScoresFromCSV(prev, mapper, warm);
+                    logLine("[Warm] " + prev + ": matched " + to_string(matched) + " nodes");
+                    if (matched > 0) warm_ptr = &warm;
+                }
+
+                AlgorithmResult& res_ppr = ppr_results[a];
+                res_ppr = (cfg.solver == "gauss-seidel")
+                    ? PPREngine::computeGaussSeidel(graph, seed_ids, alpha, cfg.policy, cfg.threads, warm_ptr)
+                    : (cfg.solver == "bicgstab")
+                    ? PPREngine::computeBiCGSTAB(graph, seed_ids, alpha, cfg.policy, warm_ptr)
+                    : PPREngine::compute(graph, seed_ids, alpha, cfg.policy, warm_ptr);
+                stringstream msg;
+                msg << "[PPR] alpha=" << alpha << " solver=" << cfg.solver
+                    << " iterations=" << res_ppr.iterations
+                    << " time=" << res_ppr.duration_us << "us"
+                    << " (" << res_ppr.stop_reason << ")";
+                logLine(msg.str());
+                if (cfg.sparse) makeSparse(res_ppr, max(0.0, cfg.min_score));
+
+                writer.enqueue([&, alpha, suffix] {
+                    if (!cfg.trace_format.empty())
+                        saveTrace("trace_PPR_alpha_" + to_string((int)(alpha * 100)) + "." + cfg.trace_format,
+                                  res_ppr, cfg.trace_format == "json");
+                    saveToCSV("results_PPR_alpha" + suffix, res_ppr, mapper, seed_ids,
+                              cfg.min_score, cfg.csv_top, sort_threads);
+                });
+            }));
+
+            jobs.push_back(pool.submit([&, a, alpha, suffix] {
+                // Hub index lives next to the dataset, one file per alpha
+                HubIndex hub_index;
+                const HubIndex* hubs = nullptr;
+                if (cfg.hubs > 0) {
+                    string index_file = filename + hub_tag + ".hubs_alpha_" + to_string((int)(alpha * 100));
+                    if (!hub_index.load(index_file, graph) || hub_index.numHubs() != min(cfg.hubs, graph.num_nodes)
+                        || fabs(hub_index.alpha() - alpha) > 1e-12) {
+                        HubIndex::build(graph, alpha, cfg.hubs, cfg.cache_top, index_file);
+                        hub_index.load(index_file, graph);
+                        logLine("[Hubs] Built index: " + index_file);
+                    }
+                    if (hub_index.numHubs() > 0) hubs = &hub_index;
+                }
+
+                AlgorithmResult& res_mc = mc_results[a];
+                res_mc = cfg.sparse
+                    ? MonteCarloEngine::computeSparse(graph, seed_ids, alpha, dynamic_walks, hubs)
+                    : MonteCarloEngine::compute(graph, seed_ids, alpha, dynamic_walks, hubs);
+                stringstream msg;
+                msg << "[MC] alpha=" << alpha << " walks=" << res_mc.iterations
+                    << " time=" << res_mc.duration_us << "us";
+                logLine(msg.str());
+
+                writer.enqueue([&, suffix] {
+                    saveToCSV("results_MC_alpha" + suffix, res_mc, mapper, seed_ids,
+                              cfg.min_score, cfg.csv_top, sort_threads);
+                });
+            }));
+        }
 
-        auto res_ppr = PPREngine::compute(graph, seed_ids, alpha, 1e-6);
-        saveToCSV("results_PPR_alpha" + suffix, res_ppr.scores, mapper, seed_ids);
+        for (auto& job : jobs) job.get();
+    }
+    writer.flush();
 
-        auto res_mc = MonteCarloEngine::compute(graph, seed_ids, alpha, dynamic_walks);
-        saveToCSV("results_MC_alpha" + suffix, res_mc.scores, mapper, seed_ids);
+    if (!cfg.binary_output.empty()) {
+        for (size_t a = 0; a < alpha_values.size(); ++a) {
+            string tag = "alpha_" + to_string((int)(alpha_values[a] * 100));
+            columns.addResult("PPR_" + tag, ppr_results[a], seed_ids);
+            columns.addResult("MC_" + tag, mc_results[a], seed_ids);
+        }
     }
 
+    if (!cfg.binary_output.empty()) columns.write(cfg.binary_output);
+
     cout << "\n[Done] All experiments completed successfully.\n";
     return 0;
 }
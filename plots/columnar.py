@@ -0,0 +1,67 @@
+import json
+import mmap
+import struct
+
+import numpy as np
+import pandas as pd
+
+# ===============================================================
+# Reader for the columnar results file written with --binary=FILE
+# Columns are viewed directly inside a memory map (zero-copy);
+# only node names are decoded into Python strings on demand.
+# ===============================================================
+
+DTYPES = {'int32': np.int32, 'float64': np.float64, 'uint8': np.uint8}
+STATUS_NAMES = np.array(['Safe', 'Suspicious', 'Seed'])
+
+
+class ColumnarResults:
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.buffer = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+        if self.buffer[:8] != b'PPRCOL1\0':
+            raise ValueError(f"{path} is not a PPRCOL1 results file")
+        (meta_len,) = struct.unpack_from('<Q', self.buffer, 8)
+        meta = json.loads(self.buffer[16:16 + meta_len].decode('utf-8'))
+
+        self.num_rows = meta['num_rows']
+        self.columns = {c['name']: c for c in meta['columns']}
+
+    def column(self, name):
+        """Returns a numpy view of a column (dictionary indices for dict_utf8)."""
+        c = self.columns[name]
+        dtype = np.int32 if c['type'] == 'dict_utf8' else DTYPES[c['type']]
+        return np.frombuffer(self.buffer, dtype=dtype,
+                             count=self.num_rows, offset=c['offset'])
+
+    def names(self, name='node_name', rows=None):
+        """Decodes dictionary-encoded strings (optionally only for some rows)."""
+        c = self.columns[name]
+        offsets = np.frombuffer(self.buffer, dtype=np.uint64,
+                                count=c['dict_count'] + 1, offset=c['dict_offsets'])
+        indices = self.column(name)
+        if rows is not None:
+            indices = indices[rows]
+        base = c['dict_data']
+        return [self.buffer[base + int(offsets[i]):base + int(offsets[i + 1])].decode('utf-8')
+                for i in indices]
+
+    def ranking(self, engine, alpha):
+        """Same layout as results_<engine>_alpha_<alpha>.csv (Rank,NodeID,Score,Status)."""
+        tag = f"{engine}_alpha_{alpha}"
+        scores = self.column('score_' + tag)
+        order = np.lexsort((-self.column('node_id'), -scores))
+        return pd.DataFrame({
+            'Rank': np.arange(1, len(order) + 1),
+            'NodeID': self.names(rows=order),
+            'Score': scores[order],
+            'Status': STATUS_NAMES[self.column('status_' + tag)[order]],
+        })
+
+
+def load_results(engine, alpha, binary_path=None):
+    """Loads one ranking from the columnar file if given, else from its CSV."""
+    if binary_path:
+        return ColumnarResults(binary_path).ranking(engine, alpha)
+    return pd.read_csv(f"results_{engine}_alpha_{alpha}.csv")
@@ -1,10 +1,14 @@
+import json
+import sys
+
 import matplotlib.pyplot as plt
 import numpy as np
 
 # ===============================================================
 # Input Section:
 # Enter the execution times obtained from the C++ console output
-# (All values are in microseconds)
+# (All values are in microseconds), or pass a benchmark JSON file
+# produced by `./fraud_detection --bench` as the first argument
 # ===============================================================
 
 # 1. Alpha = 0.15
@@ -19,6 +23,28 @@ time_mc_50  = 1066008
 time_ppr_85 = 3431
 time_mc_85  = 435158
 
+# ===============================================================
+# Optional: take the times from the benchmark JSON instead
+# (largest graph of the first generator, single thread)
+# ===============================================================
+if len(sys.argv) > 1:
+    with open(sys.argv[1]) as f:
+        records = json.load(f)['records']
+
+    generator = records[0]['generator']
+    runs = [r for r in records if r['generator'] == generator and r['threads'] == 1]
+    largest = max(r['nodes'] for r in runs)
+
+    def bench_time(phase, alpha):
+        for r in runs:
+            if r['nodes'] == largest and r['phase'] == phase and abs(r['alpha'] - alpha) < 1e-9:
+                return r['time_us']
+        return 0
+
+    time_ppr_15, time_mc_15 = bench_time('ppr', 0.15), bench_time('mc', 0.15)
+    time_ppr_50, time_mc_50 = bench_time('ppr', 0.50), bench_time('mc', 0.50)
+    time_ppr_85, time_mc_85 = bench_time('ppr', 0.85), bench_time('mc', 0.85)
+
 # ===============================================================
 
 # Prepare data for plotting
@@ -1,15 +1,19 @@
+import sys
 import pandas as pd
 import matplotlib.pyplot as plt
 import numpy as np
+from columnar import load_results
 
 # ===============================================================
 # Step 1: Load result CSV files generated by the C++ program
 # ===============================================================
-# Assumes the following files exist in the same directory
+# Assumes the following files exist in the same directory,
+# or a columnar results file (--binary=FILE) passed as the first argument
+binary_path = sys.argv[1] if len(sys.argv) > 1 else None
 try:
-    df_15 = pd.read_csv("results_PPR_alpha_15.csv")
-    df_50 = pd.read_csv("results_PPR_alpha_50.csv")
-    df_85 = pd.read_csv("results_PPR_alpha_85.csv")
+    df_15 = load_results("PPR", 15, binary_path)
+    df_50 = load_results("PPR", 50, binary_path)
+    df_85 = load_results("PPR", 85, binary_path)
 except FileNotFoundError:
     print("Error: CSV files not found! Make sure you ran the C++ code.")
     exit()
@@ -1,11 +1,15 @@
+import sys
 import pandas as pd
 import matplotlib.pyplot as plt
+from columnar import load_results
 
 # ===============================================================
 # Step 1: Load the main result file (standard configuration)
 # ===============================================================
+# Optionally read from a columnar results file (--binary=FILE) instead
+binary_path = sys.argv[1] if len(sys.argv) > 1 else None
 try:
-    df = pd.read_csv("results_PPR_alpha_15.csv")
+    df = load_results("PPR", 15, binary_path)
 except:
     print("CSV file not found.")
     exit()